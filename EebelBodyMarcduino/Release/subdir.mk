@@ -8,10 +8,12 @@ C_SRCS += \
 ../fifo.c \
 ../i2c.c \
 ../main.c \
+../pca9685.c \
 ../realtime.c \
 ../sequencer.c \
 ../serial.c \
 ../servo.c \
+../servo_out.c \
 ../suart.c \
 ../wmath.c 
 
@@ -20,10 +22,12 @@ OBJS += \
 ./fifo.o \
 ./i2c.o \
 ./main.o \
+./pca9685.o \
 ./realtime.o \
 ./sequencer.o \
 ./serial.o \
 ./servo.o \
+./servo_out.o \
 ./suart.o \
 ./wmath.o 
 
@@ -32,10 +36,12 @@ C_DEPS += \
 ./fifo.d \
 ./i2c.d \
 ./main.d \
+./pca9685.d \
 ./realtime.d \
 ./sequencer.d \
 ./serial.d \
 ./servo.d \
+./servo_out.d \
 ./suart.d \
 ./wmath.d 
 
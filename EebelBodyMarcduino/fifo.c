@@ -3,7 +3,7 @@
  * In order to use, initialize like this:
  *
  * 	#include "fifo.h"
- * 	#define BUF_SIZE 10
+ * 	#define BUF_SIZE 16		// a power of two, up to 256
  * 	uint8_t buffer[BUF_SIZE];
  * 	fifo_t fifo;
  * 	...
@@ -13,13 +13,15 @@
  * 	***************************************/
 
 
+#include <string.h>
 #include "fifo.h"
 
-void fifo_init (fifo_t *f, uint8_t *buffer, const uint8_t size)
+// size has to be a power of two, see FIFO_SIZE_OK()
+void fifo_init (fifo_t *f, uint8_t *buffer, const uint16_t size)
 {
-	f->count = 0;
-	f->pread = f->pwrite = buffer;
-	f->read2end = f->write2end = f->size = size;
+	f->head = f->tail = 0;
+	f->mask = (uint8_t)(size - 1);
+	f->buf = buffer;
 }
 
 uint8_t fifo_put (fifo_t *f, const uint8_t data)
@@ -29,7 +31,7 @@ uint8_t fifo_put (fifo_t *f, const uint8_t data)
 
 uint8_t fifo_get_wait (fifo_t *f)
 {
-	while (!f->count);
+	while (f->head == f->tail);
 	
 	return _inline_fifo_get (f);	
 }
@@ -37,7 +39,7 @@ uint8_t fifo_get_wait (fifo_t *f)
 // uses -1 (0xFF) as error code for empty. Maybe I want to change that with an available function.
 int fifo_get_nowait (fifo_t *f)
 {
-	if (!f->count)		return -1;
+	if (f->head == f->tail)		return -1;
 		
 	return (int) _inline_fifo_get (f);	
 }
@@ -45,7 +47,41 @@ int fifo_get_nowait (fifo_t *f)
 // available function would look like this
 int fifo_available(fifo_t *f)
 {
-	 if(f->count) return 1;
+	 if(f->head != f->tail) return 1;
 	 else return 0;
 }
 
+// stores as much of data as fits, with a single index update
+uint8_t fifo_write (fifo_t *f, const uint8_t *data, uint8_t n)
+{
+	uint8_t head = f->head;
+	uint8_t space = fifo_space(f);
+	uint16_t first;
+
+	if (n > space) n = space;
+	// copy up to the end of the buffer, then the rest from the start
+	first = (uint16_t)f->mask + 1 - head;
+	if (first > n) first = n;
+	memcpy (f->buf + head, data, first);
+	memcpy (f->buf, data + first, n - first);
+	fifo_barrier();
+	f->head = (head + n) & f->mask;
+	return n;
+}
+
+// reads up to n bytes, with a single index update
+uint8_t fifo_read (fifo_t *f, uint8_t *data, uint8_t n)
+{
+	uint8_t tail = f->tail;
+	uint8_t count = fifo_count(f);
+	uint16_t first;
+
+	if (n > count) n = count;
+	first = (uint16_t)f->mask + 1 - tail;
+	if (first > n) first = n;
+	memcpy (data, f->buf + tail, first);
+	memcpy (data + first, f->buf, n - first);
+	fifo_barrier();
+	f->tail = (tail + n) & f->mask;
+	return n;
+}
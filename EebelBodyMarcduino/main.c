@@ -112,6 +112,8 @@
  * :STxx buzz kill/soft hold: removes panel from RC control AND shuts servo off to eliminate buzz.
  * 		xx=00 all panels off RC servos off.
  * :HDxx RC hold: removes from RC, but does not turn servo off, keeps at last position. xx=00 all panels hold.
+ * :TExx sequence tempo, to keep the panel routines in time with the music. xx=50 normal speed,
+ * 		one percent per step, TE40 plays the sequences at 90%, TE60 at 110%. xx=00 back to normal.
  *
  *	Sequences details (see sequence_command, panel sequence matrices defined in panel_sequences.h)
  *	:SE00 Close all panels (full speed), servo off - use as init only. Use CL00 for all soft close.
@@ -157,9 +159,10 @@
 
 #include "toolbox.h"
 #include "servo.h"			// servo drivers
+#include "servo_out.h"		// servo outputs of the sequencer, including the I2C ones
 #include "realtime.h"		// real time interrupt services
 #include "serial.h"			// hardware serial
-#include "suart.h"			// software serial (write only)
+#include "suart.h"			// software serial
 #include "sequencer.h"		// servo sequencer
 #include "panel_sequences.h"	// panel sequences, moved off to another file for clarity
 
@@ -172,8 +175,12 @@
 #include "i2c.h"			// include I2C Master libraries for MarcDuino v2
 #endif
 
+// command lines are assembled by the serial receive interrupt
+#if !defined(SERIAL_LINE_INPUT) || SERIAL_LINE_LENGTH!=CMD_MAX_LENGTH || SERIAL_LINE_END!=CMD_END_CHAR
+#error serial.h line input must be on and match the command length and end character
+#endif
+
 // command globals
-char command_buffer[CMD_MAX_LENGTH];		// command string buffer
 uint8_t panel_rc_control[SERVO_NUM];		// flag array for which panels are under RC control
 uint8_t panel_to_silence[SERVO_NUM];		// flag array for servos we need to turn off after a panel is closed
 
@@ -187,6 +194,9 @@ rt_timer killbuzz_timer;
 //### experimental: timer to close TCP connection if no data received, for 3 seconds
 rt_timer TCP_timer;
 
+// serial_lines_dropped() count already reported
+uint8_t lines_dropped_reported=0;
+
 // Eebel Start
 // Below are the arrays for the Default Open and close pulse positions
 // I need to somehow pass this to the Body Marcduino from the controlling Arduino
@@ -202,18 +212,25 @@ const char strEnterPrompt[] PROGMEM="Enter panel command starting with \':\' \n\
 const char strSuart1OK[] PROGMEM="\n\rsuart1 Communication OK \n\r";
 const char strSuart2OK[] PROGMEM="\n\rsuart2 Communication OK \n\r";
 const char strStartCharErr[] PROGMEM="**Unrecognized Command Start Character\r\n";
+const char strLineDropErr[] PROGMEM="**Command Lines Dropped, Input Buffers Full\r\n";
 const char strInitializing[] PROGMEM="Initializing...\r\n";
 
-// utility to echo characters back cleanly
-void echo(char ch)
+// utility to echo a command line back cleanly
+// only what was kept of the line is echoed, a line longer than CMD_MAX_LENGTH-1 comes back cut
+void echo(char* line)
 {
-	// echo return and line feeds nicely on a terminal
-	if(ch=='\r' || ch=='\n' || ch == 0x0D )
+	// echo line feeds and the end of line nicely on a terminal
+	for(; *line; line++)
 	{
-		serial_putc('\n');
-		serial_putc('\r');
+		if(*line=='\n')
+		{
+			serial_putc('\n');
+			serial_putc('\r');
+		}
+		else serial_putc(*line);
 	}
-	else serial_putc(ch);
+	serial_putc('\n');
+	serial_putc('\r');
 }
 
 
@@ -241,11 +258,15 @@ int main(void) {
 	servo_init();
 	realtime_init();
 	seq_init();
+	seq_loadpositions(panel_positions, SEQ_SIZE(panel_positions));	// for the packed sequences
+	if(feedbackmessageon) report_packed_sequences();
 
 #ifdef _MARCDUINOV2_
 	// initialize I2C hardware on MarcDuino v2's with 10k pull-up resistors on.
 	i2c_init(TRUE);
 #endif
+	// sequencer servo outputs beyond SERVO_NUM, if any (see servo_out.h)
+	servo_out_init();
 
 	// register our buzz kill timer
 	rt_add_timer(&killbuzz_timer);
@@ -279,20 +300,26 @@ int main(void) {
 	/////////////////////////////////////////
 	// Serial Command Input
 	////////////////////////////////////////
-	char command_str[CMD_MAX_LENGTH];
-	bool command_available;
+	int8_t line;
+	char* command_str;
 
-	// check for command line input
-	if(serial_available())
+	// handle all the complete command lines, they are used in place in the serial line buffers
+	while((line=serial_line_get())>=0)
 	{
 		//### experimental, reset TCP timeout timer
 		TCP_timer=TCP_TIMER_VALUE;
 
-		char ch;
-		ch=serial_getc();										// get input
-		echo(ch);												// echo back
-		command_available=build_command(ch, command_str);		// build command line
-		if (command_available) dispatch_command(command_str);	// send command line to dispatcher
+		command_str=serial_line(line);
+		echo(command_str);							// echo back
+		dispatch_command(command_str);				// send command line to dispatcher
+		serial_line_release();						// buffer can take a new line
+	}
+
+	// report lines lost while all the line buffers were waiting (a long command was running)
+	if(serial_lines_dropped()!=lines_dropped_reported)
+	{
+		lines_dropped_reported=serial_lines_dropped();
+		if(errormessageon) serial_puts_p(strLineDropErr);
 	}
 
 	///////////////////////////////////////////
@@ -351,6 +378,7 @@ int main(void) {
 	////////////////////////////////////////
 	int16_t servovalue= servo_RCread();
 	uint8_t i;
+	servo_stage_begin();	// RC controlled panels move together
 	for(i=1; i<=SERVO_NUM; i++)
 	{
 		if(panel_rc_control[i-1]==1)
@@ -372,10 +400,12 @@ int main(void) {
 			}
 		}
 	}
+	servo_stage_commit();
 
 	// kill servo buzz if panel have been marked as just closed and the timeout period has expired
 	if(killbuzz_timer==0)
 	{
+		servo_stage_begin();
 		for(int i=1; i<=SERVO_NUM; i++)
 		{
 			if(panel_to_silence[i-1])
@@ -384,8 +414,14 @@ int main(void) {
 				panel_to_silence[i-1]=0;
 			}
 		}
+		servo_stage_commit();
 	}
 
+	/////////////////////////////////////////
+	// Servo outputs on I2C
+	////////////////////////////////////////
+	servo_out_task();
+
 	// simple debug RC input test: loopback input to servo
 	// servo_set(2, servo_RCread());
 
@@ -399,28 +435,6 @@ int main(void) {
 return 0;
 }
 
-// builds the command string from the character input
-uint8_t build_command(char ch, char* output_str)
-{
-	static uint8_t pos=0;
-
-	switch(ch)
-	{
-		case CMD_END_CHAR:								// end character recognized
-			command_buffer[pos]='\0';					// append the end of string character
-			pos=0;										// reset buffer pointer
-			strcpy(output_str, (char*)command_buffer);	// copy result
-			return TRUE;								// return and signal command ready
-			break;
-
-		default:										// regular character
-			command_buffer[pos]=ch;						// append the  character to the command string
-			if(pos<=CMD_MAX_LENGTH-1)pos++;				// too many characters, discard them.
-			break;
-	}
-	return FALSE;
-}
-
 // dispatches further command processing depending on start character
 void dispatch_command(char* command_str)
 {
@@ -757,6 +771,9 @@ void parse_panel_command(char* command_string, uint8_t length)
 	 * :HDxx as hold (hard hold)
 	 * 	Removes RC, hold the servo to last position
 	 * 	00=all panels that had RC will hold
+	 * :TExx as sequence tempo
+	 * 	50=normal, 01...99 = 51% to 149%
+	 * 	00=normal
 	 *
 	 */
 
@@ -833,6 +850,12 @@ void process_command(char* thecommand, char* theargument)
 		hold_command(value);
 		return;
 	};
+	if(strcmp(thecommand,CMD_TEMPO )==0)
+	{
+		serial_puts_p(strOK);
+		tempo_command(value);
+		return;
+	};
 
 	if(errormessageon) serial_puts_p(strPanelCmdErr);
 
@@ -866,6 +889,14 @@ const char strSeqBodyUseInterfaceTool[] PROGMEM="(Body Use Interface Tool) \r\n"
 const char strSeqBodyPingPongBodyDoors[] PROGMEM="(Ping Pong Big Body Doors) \r\n";
 //Eebel END
 
+// the tool sequences run on their own tracks, alongside the panel sequences of the main track
+#define SEQ_TRACK_UTILITY_ARMS	1
+#define SEQ_TRACK_LEFT_TOOL		2
+#define SEQ_TRACK_RIGHT_TOOL	3
+#define SEQ_UTILITY_ARMS_SERVOS	(SEQ_SERVO(2)|SEQ_SERVO(3))					// upper and lower utility arms
+#define SEQ_LEFT_TOOL_SERVOS	(SEQ_SERVO(4)|SEQ_SERVO(5)|SEQ_SERVO(6))	// left door, arm and gripper
+#define SEQ_RIGHT_TOOL_SERVOS	(SEQ_SERVO(7)|SEQ_SERVO(8)|SEQ_SERVO(9))	// right door, arm and interface tool
+
 void sequence_command(uint8_t value)
 {
 	char string[35];
@@ -900,7 +931,7 @@ void sequence_command(uint8_t value)
 			break;
 
 		case 3: // MOODY FAST WAVE
-			seq_loadsequence(panel_fast_wave, SEQ_SIZE(panel_fast_wave));
+			seq_loadgenerator(&panel_fast_wave);
 			seq_resetspeed();
 			DisplayFlash4();  					// 4 seconds flash display
 			HPFlicker(4);						// HPs flicker for 4 seconds
@@ -910,7 +941,7 @@ void sequence_command(uint8_t value)
 			break;
 
 		case 4: // OPEN WAVE
-			seq_loadsequence(panel_open_close_wave, SEQ_SIZE(panel_open_close_wave));
+			seq_loadgenerator(&panel_open_close_wave);
 			seq_resetspeed();
 			HPFlash(5); 	 					// HPs flash for 5 seconds
 			SoundOpenWave(); 					// long happy sound
@@ -920,7 +951,7 @@ void sequence_command(uint8_t value)
 
 		case 5: // Beep Cantina (R2 beeping the cantina, panels doing marching ants)
 			seq_add_completion_callback(resetJEDIcallback); 	// callback to reset displays at end of sequence
-			seq_loadsequence(panel_marching_ants, SEQ_SIZE(panel_marching_ants));
+			seq_loadgenerator(&panel_marching_ants);
 			seq_loadspeed(panel_slow_speed);					// slow speed marching ants
 			DisplaySpectrum();	 								// spectrum display
 			HPFlash(17); 	 									// HPs flash for 17 seconds
@@ -942,7 +973,7 @@ void sequence_command(uint8_t value)
 
 		case 7: // Cantina (Orchestral Cantina, Rhythmic Panels)
 			seq_add_completion_callback(resetJEDIcallback); 	// callback to reset displays at end of sequence
-			seq_loadsequence(panel_dance, SEQ_SIZE(panel_dance));
+			seq_loadpacked(panel_dance);
 			seq_resetspeed();
 			SoundCantina();		 				// code for dance sound
 			DisplaySpectrum();	 				// spectrum display
@@ -967,7 +998,7 @@ void sequence_command(uint8_t value)
 		case 9:	// DISCO
 			seq_add_completion_callback(resetJEDIcallback); // callback to reset displays at end of sequence
 			seq_resetspeed();
-			seq_loadsequence(panel_long_disco, SEQ_SIZE(panel_long_disco)); // 6:26 seconds sequence
+			seq_loadpacked(panel_long_disco); // 6:26 seconds sequence
 			// message on the logics
 			//suart_puts("@1MR2 D2   \r"); 		// message is top front is R2
 			//_delay_ms(200);
@@ -1059,12 +1090,12 @@ void sequence_command(uint8_t value)
 			break;
 //Eebel Case 16 to 29 used for DOME.  I know I can use the numbers in the body cases.  Just trying to keep it easy
 		case 30: // Utility ARM open and close sequence
-			seq_loadsequence(utility_arms_open, SEQ_SIZE(utility_arms_open));
-			seq_loadspeed(panel_medium_speed);	// go medium
+			seq_track_loadsequence(SEQ_TRACK_UTILITY_ARMS, utility_arms_open, SEQ_SIZE(utility_arms_open), SEQ_UTILITY_ARMS_SERVOS);
+			seq_track_loadspeed(SEQ_TRACK_UTILITY_ARMS, panel_medium_speed);	// go medium
 			//SoundCantina();		 				// code for dance sound
 			//DisplaySpectrum();	 				// spectrum display
 			HPFlicker(4); 						// HPs flicker for 4 sec
-			seq_startsequence();				// start panel sequence
+			seq_track_startsequence(SEQ_TRACK_UTILITY_ARMS);	// start arms sequence, the panels keep going
 			if(feedbackmessageon) serial_puts_p(strSeqUtilityOpenClose);	// debug console feedback
 			break;
 		case 31: // All Body Panels open and close sequence
@@ -1086,21 +1117,21 @@ void sequence_command(uint8_t value)
 			if(feedbackmessageon) serial_puts_p(strSeqBodyDoorSpook);	// debug console feedback
 			break;
 		case 33: //Body - Use Gripper
-			seq_loadsequence(panel_use_gripper, SEQ_SIZE(panel_use_gripper));
-			seq_loadspeed(panel_fast_speed);	// go medium, Try fast speed
+			seq_track_loadsequence(SEQ_TRACK_LEFT_TOOL, panel_use_gripper, SEQ_SIZE(panel_use_gripper), SEQ_LEFT_TOOL_SERVOS);
+			seq_track_loadspeed(SEQ_TRACK_LEFT_TOOL, panel_fast_speed);	// go medium, Try fast speed
 			//SoundCantina();		 				// code for dance sound
 			//DisplaySpectrum();	 				// spectrum display
 			//HPFlicker(4); 						// HPs flicker for 4 sec
-			seq_startsequence();				// start panel sequence
+			seq_track_startsequence(SEQ_TRACK_LEFT_TOOL);	// start gripper sequence
 			if(feedbackmessageon) serial_puts_p(strSeqBodyUseGripper);	// debug console feedback
 			break;
 		case 34: //Body - Use Interface Tool
-			seq_loadsequence(panel_use_interface_tool, SEQ_SIZE(panel_use_interface_tool));
-			seq_loadspeed(panel_fast_speed);	// go fast
+			seq_track_loadsequence(SEQ_TRACK_RIGHT_TOOL, panel_use_interface_tool, SEQ_SIZE(panel_use_interface_tool), SEQ_RIGHT_TOOL_SERVOS);
+			seq_track_loadspeed(SEQ_TRACK_RIGHT_TOOL, panel_fast_speed);	// go fast
 			//SoundCantina();		 				// code for dance sound
 			//DisplaySpectrum();	 				// spectrum display
 			//HPFlicker(4); 						// HPs flicker for 4 sec
-			seq_startsequence();				// start panel sequence
+			seq_track_startsequence(SEQ_TRACK_RIGHT_TOOL);	// start interface tool sequence
 			if(feedbackmessageon) serial_puts_p(strSeqBodyUseInterfaceTool);	// debug console feedback
 			break;
 		case 35: //Body - Ping Pong Body Doors
@@ -1137,19 +1168,19 @@ void sequence_command(uint8_t value)
 			if(feedbackmessageon) serial_puts_p(strSeqWave);
 			break;
 		case 53: // MOODY FAST WAVE
-			seq_loadsequence(panel_fast_wave, SEQ_SIZE(panel_fast_wave));
+			seq_loadgenerator(&panel_fast_wave);
 			seq_resetspeed();
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqFastWave);
 			break;
 		case 54: // WAVE2
-			seq_loadsequence(panel_open_close_wave, SEQ_SIZE(panel_open_close_wave));
+			seq_loadgenerator(&panel_open_close_wave);
 			seq_resetspeed();
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqOpenCloseWave);
 			break;
 		case 55: // Marching ant
-			seq_loadsequence(panel_marching_ants, SEQ_SIZE(panel_marching_ants));
+			seq_loadgenerator(&panel_marching_ants);
 			seq_loadspeed(panel_slow_speed);	// softer close
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqMarchingAnts);
@@ -1161,7 +1192,7 @@ void sequence_command(uint8_t value)
 			if(feedbackmessageon) serial_puts_p(strSeqShortCircuit);
 			break;
 		case 57: // Rhythmic Panels
-			seq_loadsequence(panel_dance, SEQ_SIZE(panel_dance));
+			seq_loadpacked(panel_dance);
 			seq_resetspeed();
 			if(feedbackmessageon) serial_puts_p(strSeqRythmicPanels);
 			seq_startsequence();
@@ -1175,7 +1206,14 @@ void sequence_command(uint8_t value)
 	}
 }
 
-
+// flash saved by the packed sequences of panel_sequences.h
+void report_packed_sequences()
+{
+	char string[60];
+	sprintf(string, "(Packed dance %d, disco %d bytes saved) \r\n",
+			SEQ_PACKED_SAVED(panel_dance), SEQ_PACKED_SAVED(panel_long_disco));
+	serial_puts(string);
+}
 
 
 void open_command(uint8_t value)
@@ -1183,6 +1221,7 @@ void open_command(uint8_t value)
 	uint8_t i;
 	if(value==0) // open all
 	{
+		servo_stage_begin();	// all panels start moving in the same servo frame
 		for (i=1; i<=SERVO_NUM; i++)
 		{
 			//servo_set(i, _OPN);
@@ -1190,6 +1229,7 @@ void open_command(uint8_t value)
 			servo_set(i, panel_open_values[i]);
 			//Eebel End
 		}
+		servo_stage_commit();
 		return;
 	}
 	if(value<=SERVO_NUM) // open specific panel
@@ -1202,6 +1242,7 @@ void open_command(uint8_t value)
 	}
 	if(value==11) // open top panels
 	{
+		servo_stage_begin();
 		for (i=7; i<=SERVO_NUM; i++)
 		{
 			//servo_set(i, _OPN);
@@ -1209,10 +1250,12 @@ void open_command(uint8_t value)
 			servo_set(i, panel_open_values[i]);
 			//Eebel End
 		}
+		servo_stage_commit();
 		return;
 	}
 	if(value==12) // open bottom panels
 	{
+		servo_stage_begin();
 		for (i=1; i<=6; i++)
 		{
 			//servo_set(i, _OPN);
@@ -1220,6 +1263,7 @@ void open_command(uint8_t value)
 			servo_set(i, panel_open_values[i]);
 			//Eebel End
 		}
+		servo_stage_commit();
 		return;
 	}
 }
@@ -1285,11 +1329,13 @@ void stop_command(uint8_t value)
 	// all panels hold to last position and servo off
 	if(value==0)
 	{
+		servo_stage_begin();
 		for(i=1; i<=SERVO_NUM; i++)
 		 {
 			 panel_rc_control[i-1]=0;
 			 servo_set(i,SERVO_NO_PULSE);
 		 }
+		servo_stage_commit();
 		return;
 	}
 
@@ -1319,6 +1365,17 @@ void hold_command(uint8_t value)
 	panel_rc_control[value-1]=0;
 }
 
+void tempo_command(uint8_t value)
+{
+	// playback rate of the running and next sequences, 50 is normal, 1% per step
+	uint16_t percent;
+	if(value>99) return;
+
+	if(value==0) percent=100;	// back to normal
+	else percent=value+50;
+	seq_settempo(((uint32_t)percent*SEQ_TEMPO_NORMAL+50)/100);
+}
+
 // sets JEDI display and Holos in their default state
 void init_jedi()
 {
@@ -72,6 +72,7 @@
 #define CMD_RC			"RC"		// put the panels under RC control (0=remove all, >=11 put them all)
 #define CMD_STOP		"ST"		// buzz kill/soft hold: remove a panel from RC control, turn servo off (0=all)
 #define CMD_HOLD		"HD"		// hard hold: remove panel from RC and hold in last position (0=all that where on RC)
+#define CMD_TEMPO		"TE"		// sequence playback tempo, 50=normal, 1% per step (00=normal)
 
 /*
 //Eebel START - define open and close Defaults for all servos.
@@ -107,8 +108,7 @@
 */
 
 
-void echo(char ch);
-uint8_t build_command(char ch, char* output_str);
+void echo(char* line);
 void dispatch_command(char* command_str);
 void parse_panel_command(char* command, uint8_t length);
 void parse_hp_command(char* command,uint8_t length);
@@ -118,11 +118,13 @@ void parse_alt1_command(char* command, uint8_t length);
 void parse_alt2_command(char* command, uint8_t length);
 void process_command(char* thecommand, char* theargument);
 void sequence_command(uint8_t value);
+void report_packed_sequences();
 void open_command(uint8_t value);
 void close_command(uint8_t value);
 void rc_command(uint8_t value);
 void stop_command(uint8_t value);
 void hold_command(uint8_t value);
+void tempo_command(uint8_t value);
 
 // i2c parsing (v1.8)
 void parse_i2c_command(char* command,uint8_t length);
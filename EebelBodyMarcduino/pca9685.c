@@ -0,0 +1,201 @@
+/*
+ * pca9685.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *      Servo outputs on PCA9685 16 channel PWM boards, see pca9685.h
+ *      Values are staged like in servo.c: writers set the value and mark the
+ *      channel changed, pca9685_task() sends the changed range of each board
+ *      in a single auto-increment write from the main loop.
+ */
+
+#include "pca9685.h"
+
+#ifdef SERVO_PCA9685
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/delay.h>
+#include "servo.h"			// for SERVO_PULSE_MIN, SERVO_PULSE_MAX and SERVO_NO_PULSE
+#include "i2c.h"
+#include "main.h"			// for _MARCDUINOV2_
+
+#ifndef _MARCDUINOV2_
+#error SERVO_PCA9685 needs the I2C bus of the MarcDuino v2
+#endif
+
+// staged values, written by pca9685_set()
+static int16_t pca9685_value[PCA9685_SERVO_NUM];		// pulse in us, SERVO_NO_PULSE for off
+static uint16_t pca9685_off[PCA9685_SERVO_NUM];			// OFF count, or PCA9685_FULL_OFF<<8 for no pulse
+
+// changed channel range of each board, first>last when nothing changed
+static volatile uint8_t pca9685_first[PCA9685_BOARDS];
+static volatile uint8_t pca9685_last[PCA9685_BOARDS];
+static volatile uint8_t pca9685_staging;	// number of writers between pca9685_stage_begin() and pca9685_stage_commit()
+
+static void pca9685_write(uint8_t board, uint8_t reg, uint8_t value)
+{
+	uint8_t data[2];
+
+	data[0]=reg;
+	data[1]=value;
+	i2c_send_data(PCA9685_ADDRESS+board, data, 2, TRUE);
+}
+
+// mark a channel changed (0 based), call with interrupts off
+static void pca9685_changed(uint8_t channel)
+{
+	uint8_t board=channel/16;
+
+	channel%=16;
+	if(pca9685_first[board]>pca9685_last[board])
+	{
+		pca9685_first[board]=channel;
+		pca9685_last[board]=channel;
+	}
+	else
+	{
+		if(channel<pca9685_first[board]) pca9685_first[board]=channel;
+		if(channel>pca9685_last[board]) pca9685_last[board]=channel;
+	}
+}
+
+/************************************************
+ * Set up all boards for 50 Hz servo pulses,
+ * with all servos off. Call after i2c_init().
+ * *********************************************/
+void pca9685_init()
+{
+	uint8_t i;
+
+	for(i=0; i<PCA9685_BOARDS; i++)
+	{
+		// the prescaler can only be written while sleeping
+		pca9685_write(i, PCA9685_MODE1, PCA9685_MODE1_SLEEP | PCA9685_MODE1_AI);
+		pca9685_write(i, PCA9685_PRE_SCALE, PCA9685_PRESCALE);
+		pca9685_write(i, PCA9685_MODE2, PCA9685_MODE2_OUTDRV);
+		pca9685_write(i, PCA9685_MODE1, PCA9685_MODE1_AI);
+		_delay_us(500);		// oscillator start up
+		pca9685_write(i, PCA9685_MODE1, PCA9685_MODE1_RESTART | PCA9685_MODE1_AI);
+
+		pca9685_first[i]=1;	// nothing changed
+		pca9685_last[i]=0;
+	}
+
+	// all servos off, sent on the first pca9685_task()
+	for(i=1; i<=PCA9685_SERVO_NUM; i++)
+	{
+		pca9685_set(i, SERVO_NO_PULSE);
+	}
+}
+
+/*****************************************************
+ * sets servo position value, same as servo_set()
+ * Valid channels are 1 to PCA9685_SERVO_NUM
+ * Values are clipped to SERVO_PULSE_MIN and SERVO_PULSE_MAX,
+ * SERVO_NO_PULSE or negative turns the output off.
+ * The value is staged, it is sent by pca9685_task()
+ *****************************************************/
+void pca9685_set(uint8_t channel, int16_t time)
+{
+	uint8_t sreg;
+	uint16_t off;
+
+	// channel must be 1 to PCA9685_SERVO_NUM
+	if(channel==0 || channel>PCA9685_SERVO_NUM) return;
+
+	if(time<=SERVO_NO_PULSE)
+	{
+		time=SERVO_NO_PULSE;
+		off=PCA9685_FULL_OFF<<8;
+	}
+	else
+	{
+		if(time>SERVO_PULSE_MAX) time=SERVO_PULSE_MAX;
+		if(time<SERVO_PULSE_MIN) time=SERVO_PULSE_MIN;
+
+		// 4096 counts per period of (PCA9685_PRESCALE+1)*4096 oscillator cycles
+		off=((uint32_t)time*(PCA9685_OSC/100000UL))/((PCA9685_PRESCALE+1)*10UL);
+	}
+
+	sreg=SREG;
+	cli();
+	pca9685_value[channel-1]=time;
+	pca9685_off[channel-1]=off;
+	pca9685_changed(channel-1);
+	SREG=sreg;
+}
+
+int16_t pca9685_read(uint8_t channel)
+{
+	uint8_t sreg;
+	int16_t value;
+
+	// channel must be 1 to PCA9685_SERVO_NUM
+	if(channel==0 || channel>PCA9685_SERVO_NUM) return 0;
+
+	sreg=SREG;
+	cli();
+	value=pca9685_value[channel-1];
+	SREG=sreg;
+	return value;
+}
+
+// staged updates, same as servo_stage_begin() / servo_stage_commit()
+void pca9685_stage_begin()
+{
+	pca9685_staging++;
+}
+
+void pca9685_stage_commit()
+{
+	if(pca9685_staging) pca9685_staging--;
+}
+
+/*****************************************************
+ * Call from the main loop
+ * For each board with changed channels, sends the
+ * changed range in one auto-increment write.
+ * Waits while a writer is staging.
+ *****************************************************/
+void pca9685_task()
+{
+	uint8_t data[1+4*16];
+	uint8_t board, first, last, i, n;
+	uint8_t sreg;
+	uint16_t off;
+
+	if(pca9685_staging) return;
+
+	for(board=0; board<PCA9685_BOARDS; board++)
+	{
+		sreg=SREG;
+		cli();
+		first=pca9685_first[board];
+		last=pca9685_last[board];
+		if(first>last)
+		{
+			SREG=sreg;
+			continue;
+		}
+		n=0;
+		data[n++]=PCA9685_LED0_ON_L+4*first;
+		for(i=first; i<=last; i++)
+		{
+			off=pca9685_off[16*board+i];
+			data[n++]=0;				// pulse starts at count 0
+			data[n++]=0;
+			data[n++]=(uint8_t)off;
+			data[n++]=(uint8_t)(off>>8);
+		}
+		pca9685_first[board]=1;	// taken
+		pca9685_last[board]=0;
+		SREG=sreg;
+
+		// not sent again on errors: a hung bus would stall the main loop
+		// for the i2c timeout on every pass. The next change resends the range.
+		i2c_send_data(PCA9685_ADDRESS+board, data, n, TRUE);
+	}
+}
+
+#endif
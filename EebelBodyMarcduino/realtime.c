@@ -421,10 +421,13 @@ ISR(TIMER0_COMP_vect, ISR_NOBLOCK)	// clear on compare mode - 32 interrupts/s
 #else
 // code for ATmega168 with 16 MHz crystal, 3 interrupts for 1/100 update intervals
 // Two counts to 208 and one count to 209 lasts 0.01 sec.
-ISR(TIMER0_COMPA_vect)
+// ISR_NOBLOCK, the realtime functions (sequencer) are long enough to delay the servo pulses
+// and the suart bits, these interrupts can come in the middle
+ISR(TIMER0_COMPA_vect, ISR_NOBLOCK)
 {
 	static uint8_t countseconds=0;
 	static uint8_t counter_phase=0;
+	static volatile uint8_t busy=0;
 
 	// first count twice to 208
 	if(counter_phase<=1)
@@ -469,7 +472,13 @@ ISR(TIMER0_COMPA_vect)
 		}
 
 		// add your short real time tasks here
-		realtime_do();
+		// if the previous tick is still running (should not happen), skip them this time
+		if(!busy)
+		{
+			busy=1;
+			realtime_do();
+			busy=0;
+		}
 	}
 }
 #endif
@@ -6,78 +6,258 @@
  */
 
 #include <avr/pgmspace.h> // for reading the sequences from program memory
+#include <avr/interrupt.h>
 #include "sequencer.h"
 #include "realtime.h"
 #include "servo.h"
 
-// sequencer global variables
-volatile int16_t seq_current[SERVO_NUM];				// current servo position array
-volatile int16_t seq_goal[SERVO_NUM];					// end goal servo position array
-rt_timer seq_timeout;									// timer until end of current sequence step
-void(*seq_completion_callback)();								// callback function when sequence ends
+// SEQ_REPEAT and SEQ_CALL return stack entry
+typedef struct
+{
+	uint8_t const *addr;						// start of the repeated block, or return address
+	uint8_t const *base;						// stream to return to
+	uint8_t count;								// repeats left
+} seq_stack_t;
+
+// a sequence running on a subset of the servos
+typedef struct
+{
+	int16_t const (*array)[SEQ_SERVO_NUM+1]; 	// array is a pointer to an array of int16_t
+												// this pointer should point to program memory
+												// we don't copy the array, just equate to the pointer passed
+	uint8_t const *packed;						// or the packed sequence, in program memory
+	uint8_t const *next;						// next packed frame
+	uint8_t const *base;						// start of the packed stream played, where SEQ_JUMP looks for labels
+	seq_stack_t stack[SEQ_STACK_DEPTH];
+	uint8_t sp;									// stack entries used
+	seq_gen_t const *gen;						// or the generated pattern, in program memory
+	uint8_t length;
+	uint8_t step;
+	uint8_t started;
+	seq_mask_t servos;							// servos owned by this track
+	int16_t const *speed;						// max speed of each servo, 0 = no limit, null for none
+												// the caller's table, we don't copy it
+	uint8_t ease;								// easing of all steps, if there is no easing array
+	uint8_t const *ease_array;					// easing of each step, in program memory
+	uint8_t step_ease;							// easing of the current step
+	uint16_t step_ticks;						// duration of the current step
+	uint16_t phase;								// progress in the current step, 0 to 256
+	uint16_t timeout;							// ticks until end of current sequence step, at the tempo
+	uint8_t late;								// ticks the last step ran over, at a fast tempo
+	void(*completion_callback)();				// callback function when sequence ends
+} seq_track_t;
 
+// sequencer global variables
+volatile int16_t seq_current[SEQ_SERVO_NUM];				// current servo position array
+volatile int16_t seq_goal[SEQ_SERVO_NUM];					// end goal servo position array
 
 // local variables
-static int16_t servo_speed[SERVO_NUM];
-static uint8_t sequence_step;
-static uint8_t sequence_started;
-static int16_t const (*sequence_array)[SERVO_NUM+1]; 	// sequence_array is a pointer to an array of int16_t
-														// this pointer should point to program memory
-														// we don't copy the array, just equate to the pointer passed
-static uint8_t sequence_length;
-
-// initialize by registering our real time callback and our timer
+static seq_track_t seq_tracks[SEQ_TRACK_NUM];
+static uint8_t seq_owner[SEQ_SERVO_NUM];			// track that owns each servo
+static volatile seq_mask_t seq_moving;				// servos that have not reached their goal yet
+static int16_t seq_start[SEQ_SERVO_NUM];			// servo position at the start of the step
+static uint16_t seq_velocity[SEQ_SERVO_NUM];		// SEQ_EASE_TRAPEZOID speed, in 1/16 of us per tick
+static int16_t const (*seq_positions)[SEQ_POS_NUM];	// SEQ_CLOSE, SEQ_OPEN and SEQ_MID of each servo, in program memory
+static uint8_t seq_positions_count;
+static uint8_t const * const *seq_subs;				// sub-sequences for SEQ_CALL, in program memory
+static uint8_t seq_subs_count;
+static volatile uint16_t seq_tempo=SEQ_TEMPO_NORMAL;	// sequence ticks per real tick, 8.8 fixed point
+static uint8_t seq_tempo_frac;						// fraction of a sequence tick carried to the next real tick
+
+// ease in and out curve, (1-cos(pi*x))/2 for x = 0 to 1 in 64 steps, 256 = 1
+static const uint16_t seq_ease_table[65] PROGMEM=
+{
+	0, 0, 1, 1, 2, 4, 6, 7, 10, 12, 15, 18, 22, 25, 29, 33,
+	37, 42, 47, 52, 57, 62, 68, 73, 79, 85, 91, 97, 103, 109, 115, 122,
+	128, 134, 141, 147, 153, 159, 165, 171, 177, 183, 188, 194, 199, 204, 209, 214,
+	219, 223, 227, 231, 234, 238, 241, 244, 246, 249, 250, 252, 254, 255, 255, 256,
+	256
+};
+
+static void seq_setservopos(seq_track_t* t, uint8_t step);
+static void seq_setgenpos(seq_track_t* t, uint8_t step);
+static uint8_t seq_gencycle(seq_gen_t const *g, uint8_t n);
+static uint8_t seq_panelcount(seq_mask_t panels);
+static void seq_rewind(seq_track_t* t);
+static uint8_t seq_packederror(seq_track_t* t);
+static uint8_t seq_nextpacked(seq_track_t* t, uint8_t apply);
+static void seq_dopacked(seq_track_t* t);
+static uint8_t seq_packedends(seq_track_t const* t);
+static void seq_setgoal(uint8_t i, int16_t goal);
+static uint8_t const* seq_skipframe(uint8_t const *p);
+static uint8_t const* seq_findlabel(uint8_t const *p, uint8_t label);
+static void seq_dotrack(seq_track_t* t);
+static void seq_steptimeout(seq_track_t* t);
+static int16_t seq_nextpos(seq_track_t* t, uint8_t i, int16_t delta);
+
+// initialize by registering our real time callback
 void seq_init()
 {
+	uint8_t i;
+	// the step timers are counted down by seq_dosequence() at the tempo, not by the realtime timers
+	// so the sequencer doesn't register any
+	// all servos start on the main track
+	for(i=0; i<SEQ_SERVO_NUM; i++)
+	{
+		seq_owner[i]=SEQ_TRACK_MAIN;
+	}
+	seq_tracks[SEQ_TRACK_MAIN].servos=SEQ_ALL_SERVOS;
 	rt_add_function(seq_dosequence);
-	rt_add_timer(&seq_timeout);
 }
 
-// pass a void function(void) to this, and it will be called at the end of the sequence
+// the original single sequence functions, work on the main track with all servos
 void seq_add_completion_callback(void(*usercallback)())
 {
-	seq_completion_callback=usercallback;
+	seq_track_add_completion_callback(SEQ_TRACK_MAIN, usercallback);
 }
 
 void seq_remove_completion_callback()
 {
-	seq_completion_callback=0;
+	seq_track_remove_completion_callback(SEQ_TRACK_MAIN);
 }
 
-// servo speed control functions
 void seq_loadspeed(speed_t speedarray)
 {
-	uint8_t i;
-	for(i=0; i<SERVO_NUM; i++ )
-	{
-		servo_speed[i]=speedarray[i];
-	}
+	seq_track_loadspeed(SEQ_TRACK_MAIN, speedarray);
 }
 
 void seq_resetspeed()
 {
-	uint8_t i;
-	for(i=0; i<SERVO_NUM; i++ )
-	{
-		servo_speed[i]=0;
-	}
+	seq_track_resetspeed(SEQ_TRACK_MAIN);
+}
+
+void seq_loadsequence(int16_t const array[][SEQ_SERVO_NUM+1], uint8_t length)
+{
+	seq_track_loadsequence(SEQ_TRACK_MAIN, array, length, SEQ_ALL_SERVOS);
+}
+
+void seq_loadgenerator(seq_gen_t const *gen)
+{
+	seq_track_loadgenerator(SEQ_TRACK_MAIN, gen, SEQ_ALL_SERVOS);
+}
+
+void seq_loadpacked(uint8_t const packed[])
+{
+	seq_track_loadpacked(SEQ_TRACK_MAIN, packed, SEQ_ALL_SERVOS);
+}
+
+void seq_startsequence()
+{
+	seq_track_startsequence(SEQ_TRACK_MAIN);
+}
+
+void seq_restartsequence()
+{
+	seq_track_restartsequence(SEQ_TRACK_MAIN);
+}
+
+void seq_stopsequence()
+{
+	seq_track_stopsequence(SEQ_TRACK_MAIN);
+}
+
+void seq_jumptostep(uint8_t step)
+{
+	seq_track_jumptostep(SEQ_TRACK_MAIN, step);
+}
+
+void seq_seteasing(uint8_t easing)
+{
+	seq_track_seteasing(SEQ_TRACK_MAIN, easing);
+}
+
+void seq_loadeasing(uint8_t const easing[])
+{
+	seq_track_loadeasing(SEQ_TRACK_MAIN, easing);
+}
+
+// pass a void function(void) to this, and it will be called at the end of the sequence
+void seq_track_add_completion_callback(uint8_t track, void(*usercallback)())
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].completion_callback=usercallback;
+}
+
+void seq_track_remove_completion_callback(uint8_t track)
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].completion_callback=0;
+}
+
+// servo speed control functions
+void seq_track_loadspeed(uint8_t track, speed_t speedarray)
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].speed=speedarray;
+}
+
+void seq_track_resetspeed(uint8_t track)
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].speed=0;
+}
+
+// easing of all the steps
+void seq_track_seteasing(uint8_t track, uint8_t easing)
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].ease_array=0;
+	seq_tracks[track].ease=easing;
 }
 
-// call this first to load the sequence array
-void seq_loadsequence(int16_t const array[][SERVO_NUM+1], uint8_t length)
+// easing of each step, the array must be in program memory and have one entry per step
+void seq_track_loadeasing(uint8_t track, uint8_t const easing[])
 {
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].ease_array=easing;
+}
+
+// call this first to load the sequence array, the track takes over the servos in the mask
+void seq_track_loadsequence(uint8_t track, int16_t const array[][SEQ_SERVO_NUM+1], uint8_t length, seq_mask_t servos)
+{
+	seq_track_t* t;
+	uint8_t i, k, sreg;
+	uint8_t preempted=0;
+	seq_mask_t bit;
+
+	if(track>=SEQ_TRACK_NUM) return;
+	t=&seq_tracks[track];
+
 	// stop previous sequence right away before changing pointer array
-	sequence_started=0;	// that will stop the sequence interrupts calls
-	sequence_step=0;	// restart at step one
+	t->started=0;	// that will stop the sequence interrupts calls
+	t->step=0;		// restart at step one
+
+	sreg=SREG;
+	cli();			// the masks are shared with seq_dosequence()
+
+	// the last track loaded wins, take our servos away from the other tracks
+	for(k=0; k<SEQ_TRACK_NUM; k++)
+	{
+		if(k==track || !(seq_tracks[k].servos & servos)) continue;
+		seq_tracks[k].servos&=~servos;
+		if(!seq_tracks[k].servos && seq_tracks[k].started)
+		{
+			seq_tracks[k].started=0;
+			preempted|=1<<k;
+		}
+	}
 
 	// point to the new sequence array and store it's length
-	sequence_array=array;
-	sequence_length=length;
+	t->array=array;
+	t->packed=0;
+	t->gen=0;
+	t->length=length;
+	t->servos=servos;
+	t->ease=SEQ_EASE_SPEED;		// the easing belongs to the previous sequence
+	t->late=0;
+	t->ease_array=0;
 
 	// init the servo current position at step 0;
-	uint8_t i;
-	for (i=1; i<=SERVO_NUM; i++)
+	for (i=1, bit=1; i<=SEQ_SERVO_NUM; i++, bit<<=1)
 	{
+		if(!(servos & bit)) continue;
+		seq_owner[i-1]=track;
+
 		/***** start with current position = first step **/
 		//seq_current[i-1]= pgm_read_word(&(array[0][i]));
 
@@ -85,58 +265,158 @@ void seq_loadsequence(int16_t const array[][SERVO_NUM+1], uint8_t length)
 		// so if there is a servo speed limit they continue smoothly from there.
 		// If the servos were not on (SERVO_NO_PULSE), they'll jump to the start position
 		// regardless of servo speed settings.
-		seq_current[i-1]= servo_read(i);
+		seq_current[i-1]= servo_out_read(i);
 		// Also equate goals to current so we start from steady state
 		seq_goal[i-1]=seq_current[i-1];
+		seq_velocity[i-1]=0;
+	}
+	seq_moving&=~servos;
+	SREG=sreg;
+
+	// a track left without any servo is stopped
+	for(k=0; k<SEQ_TRACK_NUM; k++)
+	{
+		if(preempted & (1<<k)) seq_track_stopsequence(k);
 	}
 }
 
+// same with a packed sequence
+void seq_track_loadpacked(uint8_t track, uint8_t const packed[], seq_mask_t servos)
+{
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_track_loadsequence(track, 0, pgm_read_byte(&packed[0]), servos);
+	seq_tracks[track].packed=packed;
+	seq_rewind(&seq_tracks[track]);
+}
+
+// the table of symbolic positions used by packed sequences, one SEQ_POSITION() per servo
+void seq_loadpositions(int16_t const table[][SEQ_POS_NUM], uint8_t count)
+{
+	seq_positions=table;
+	seq_positions_count=count;
+}
+
+// load a generated sequence, see seq_gen_t in sequencer.h
+void seq_track_loadgenerator(uint8_t track, seq_gen_t const *gen, seq_mask_t servos)
+{
+	seq_gen_t g;
+	uint8_t n;
+	uint16_t length;
+
+	if(track>=SEQ_TRACK_NUM) return;
+	memcpy_P(&g, gen, sizeof(g));
+	n=seq_panelcount(g.panels);
+	if(!n) return;
+
+	// first frame, the cycles, the closing frame and the no pulse frame
+	length=(uint16_t)g.repeats*seq_gencycle(&g, n)+3;
+	if(length>255) length=255;
+
+	seq_track_loadsequence(track, 0, (uint8_t)length, servos);
+	seq_tracks[track].gen=gen;
+}
+
+// the sub-sequences SEQ_CALL(n) plays, table[n] points to a stream ending with SEQ_RETURN
+// the table must be in program memory
+void seq_loadsubsequences(uint8_t const * const table[], uint8_t count)
+{
+	seq_subs=table;
+	seq_subs_count=count;
+}
+
+// flash saved by a packed sequence, compared to the same sequence_t
+int16_t seq_packed_saved(uint8_t const packed[], uint16_t size)
+{
+	return pgm_read_byte(&packed[0])*(SEQ_SERVO_NUM+1)*sizeof(int16_t)-size;
+}
+
+// playback rate of all the tracks, 8.8 fixed point, SEQ_TEMPO_NORMAL is the time of the sequences
+// Can be changed while sequences run, the step being played goes on at the new rate.
+void seq_settempo(uint16_t tempo)
+{
+	uint8_t sreg=SREG;
+	cli();
+	seq_tempo=tempo;
+	SREG=sreg;
+}
+
+uint16_t seq_gettempo()
+{
+	uint16_t tempo;
+	uint8_t sreg=SREG;
+	cli();
+	tempo=seq_tempo;
+	SREG=sreg;
+	return tempo;
+}
+
 // call this second to execute the sequence from the beginning
-void seq_startsequence()
+void seq_track_startsequence(uint8_t track)
 {
-	sequence_step=0;
-	sequence_started=1;
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].step=0;
+	seq_tracks[track].late=0;
+	if(seq_tracks[track].packed) seq_rewind(&seq_tracks[track]);
+	seq_tracks[track].started=1;
 }
 
 // this will restart the sequence from the point where it was stopped
-void seq_restartsequence()
+void seq_track_restartsequence(uint8_t track)
 {
-	sequence_started=1;
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].started=1;
 }
 
 // this will stop the sequencer
-void seq_stopsequence()
+void seq_track_stopsequence(uint8_t track)
 {
-	sequence_started=0;
-	seq_timeout=0;
-	if(seq_completion_callback) seq_completion_callback();
+	if(track>=SEQ_TRACK_NUM) return;
+	seq_tracks[track].started=0;
+	seq_tracks[track].timeout=0;
+	if(seq_tracks[track].completion_callback) seq_tracks[track].completion_callback();
 }
 
 // call this before calling restart to specify a specific step from which to restart
-void seq_jumptostep(uint8_t step)
+void seq_track_jumptostep(uint8_t track, uint8_t step)
 {
-	if(step<sequence_length) sequence_step=step;
+	uint8_t i;
+	if(track>=SEQ_TRACK_NUM) return;
+	if(step>=seq_tracks[track].length) return;
+	// packed frames have different sizes and control flow, play the frames up to step without moving the servos
+	if(seq_tracks[track].packed)
+	{
+		seq_rewind(&seq_tracks[track]);
+		for(i=0; i<step; i++) seq_nextpacked(&seq_tracks[track], 0);
+	}
+	seq_tracks[track].step=step;
+}
+
+uint8_t seq_track_running(uint8_t track)
+{
+	if(track>=SEQ_TRACK_NUM) return 0;
+	return seq_tracks[track].started;
 }
 
 // internal functions
 
 /*******old implementation, directly set the position of the servos.
  // Use this if you do not need any servo speed control
-void seq_setservopos(int16_t array[][SERVO_NUM+1], uint8_t step)
+void seq_setservopos(int16_t array[][SEQ_SERVO_NUM+1], uint8_t step)
 {
 	uint8_t i;
 	// servo numbering starts at 1 in both the array and the numbering scheme of servo_set
-	for (i=1; i<=SERVO_NUM; i++)
+	for (i=1; i<=SEQ_SERVO_NUM; i++)
 	{
-		servo_set(i, array[step][i]);
+		servo_out_set(i, array[step][i]);
 	}
 }
 ******************/
 
 // new version with servo speed control
-void seq_setservopos(int16_t const array[][SERVO_NUM+1], uint8_t step)
+static void seq_setservopos(seq_track_t* t, uint8_t step)
 {
 	uint8_t i;
+	seq_mask_t bit;
 	// This doesn't set the servo position directly anymore.
 	// It just sets a goal for the the servo to get to.
 	// The actual position sent to the servo will move progressively toward the goal
@@ -144,19 +424,311 @@ void seq_setservopos(int16_t const array[][SERVO_NUM+1], uint8_t step)
 	// The servo actual position updates now occurs at interrupt time in seq_dosequence()
 	// and are calculated from the servo goal and servo speed values.
 
-	for (i=1; i<=SERVO_NUM; i++)
+	if(t->gen)
+	{
+		seq_setgenpos(t, step);
+		return;
+	}
+
+	// time based easings spread the move over the step time
+	t->step_ease= t->ease_array ? pgm_read_byte(&(t->ease_array[step])) : t->ease;
+	t->step_ticks=pgm_read_word(&(t->array[step][0]));
+	t->phase=0;
+
+	servo_out_stage_begin();
+	for (i=1, bit=1; i<=SEQ_SERVO_NUM; i++, bit<<=1)
+	{
+		if(!(t->servos & bit)) continue;	// servo belongs to another track
+		seq_setgoal(i-1, pgm_read_word(&(t->array[step][i])));
+	}
+	servo_out_stage_commit();
+}
+
+// number of servos in a generator mask
+static uint8_t seq_panelcount(seq_mask_t panels)
+{
+	uint8_t n=0;
+	for(; panels; panels>>=1)
 	{
-		// just udpate the goals, but not the position of the servos directly
-		seq_goal[i-1]=pgm_read_word(&(array[step][i]));
-		// cutting off servo pulses is the only immediate servo assignment
-		if(seq_goal[i-1]==SERVO_NO_PULSE){servo_set(i,SERVO_NO_PULSE);
-		// all other servo assignment take place at interrupt time in seq_dosequence()
+		if(panels&1) n++;
+	}
+	return n;
+}
+
+// frames in one cycle of a generated pattern on n panels
+static uint8_t seq_gencycle(seq_gen_t const *g, uint8_t n)
+{
+	switch(g->pattern)
+	{
+		case SEQ_GEN_FILL:
+			return 2*n-1;				// open 1 to n, then close 1 to n-1, the closing frame closes the last one
+		case SEQ_GEN_ANTS:
+			return 2;
+		default:	// SEQ_GEN_WAVE
+			if(g->flags & SEQ_GEN_BOUNCE) return 2*n+1;	// there, all closed, and back
+			return n;
+	}
+}
+
+// computes the frame at step of a generated sequence, and sets the goals like seq_setservopos()
+// frame 0 closes the panels, then come the pattern cycles, the closing frame and the no pulse frame
+static void seq_setgenpos(seq_track_t* t, uint8_t step)
+{
+	seq_gen_t g;
+	uint8_t i, j, k=0, n, place, open=0;
+	uint8_t frame;		// 0 all closed, 1 pattern, 2 no pulse
+	seq_mask_t bit;
+	int16_t goal;
+	int16_t const (*table)[SEQ_POS_NUM];
+	uint8_t count;
+
+	memcpy_P(&g, t->gen, sizeof(g));
+	n=seq_panelcount(g.panels);
+	table= g.positions ? g.positions : seq_positions;
+	count= g.positions ? SEQ_SERVO_NUM : seq_positions_count;
+
+	t->step_ease= t->ease_array ? pgm_read_byte(&(t->ease_array[step])) : t->ease;
+	t->phase=0;
+	if(step==0)
+	{
+		frame=0;
+		t->step_ticks=g.lead;
+	}
+	else if(step==t->length-1)
+	{
+		frame=2;
+		t->step_ticks=0;
+	}
+	else if(step==t->length-2)
+	{
+		frame=0;
+		t->step_ticks=g.tail;
+	}
+	else
+	{
+		frame=1;
+		k=(step-1)%seq_gencycle(&g, n);
+		t->step_ticks= (g.pattern==SEQ_GEN_FILL && k==n-1) ? g.hold : g.period;
+	}
+
+	servo_out_stage_begin();
+	for(i=0, j=0, bit=1; i<SEQ_SERVO_NUM; i++, bit<<=1)
+	{
+		if(!(g.panels & bit)) continue;
+		// j is the place of the servo in the pattern
+		if(frame==1)
+		{
+			place= (g.flags & SEQ_GEN_REVERSE) ? n-1-j : j;
+			switch(g.pattern)
+			{
+				case SEQ_GEN_FILL:
+					open= k<n ? place<=k : place>k-n;
+					break;
+				case SEQ_GEN_ANTS:
+					open=!((place+k)&1);
+					break;
+				default:	// SEQ_GEN_WAVE
+					if(k<n) open= place==k;
+					else open= place==2*n-k;	// on the way back, k==n closes all
+					break;
+			}
+		}
+		j++;
+		if(!(t->servos & bit)) continue;	// servo belongs to another track
+		if(frame==2) goal=SERVO_NO_PULSE;
+		else if(i>=count) continue;			// no position table for this servo
+		else goal=pgm_read_word(&(table[i][open ? SEQ_OPEN : SEQ_CLOSE]));
+		seq_setgoal(i, goal);
+	}
+	servo_out_stage_commit();
+}
+
+// back to the start of a packed sequence
+static void seq_rewind(seq_track_t* t)
+{
+	t->base=t->next=t->packed+1;	// skip the number of frames
+	t->sp=0;
+	t->step=0;
+}
+
+// a wrong packed sequence is stopped instead of looping
+static uint8_t seq_packederror(seq_track_t* t)
+{
+	t->step_ticks=0;
+	return 0;
+}
+
+// runs the control flow opcodes of a packed sequence up to the next frame, and decodes it
+// (see sequencer.h for the format). With apply at 0 the servo goals are not changed.
+// Returns 0 at SEQ_END, or if the sequence is wrong (stack overflow, unknown sub-sequence or label,
+// or a loop without frames), then the step time is cleared so that the sequence stops.
+static uint8_t seq_nextpacked(seq_track_t* t, uint8_t apply)
+{
+	uint8_t const *p;
+	uint8_t i, b, op, arg;
+	uint8_t budget=SEQ_MAX_OPS;
+	uint16_t ticks;
+	seq_mask_t changed, bit;
+	int16_t goal;
+	seq_stack_t *s;
+
+	p=t->next;
+	while(pgm_read_byte(p)==SEQ_OP)
+	{
+		if(!budget--) return seq_packederror(t);
+		op=pgm_read_byte(p+1);
+		arg=pgm_read_byte(p+2);
+		p+=2;
+		switch(op)
+		{
+			case SEQ_OP_REPEAT:
+				p++;
+				if(t->sp>=SEQ_STACK_DEPTH) return seq_packederror(t);
+				s=&t->stack[t->sp++];
+				s->addr=p;
+				s->base=t->base;
+				s->count=arg;
+				break;
+			case SEQ_OP_END_REPEAT:
+				if(!t->sp) return seq_packederror(t);
+				s=&t->stack[t->sp-1];
+				if(s->count>1)
+				{
+					s->count--;
+					p=s->addr;
+				}
+				else t->sp--;
+				break;
+			case SEQ_OP_CALL:
+				p++;
+				if(t->sp>=SEQ_STACK_DEPTH || arg>=seq_subs_count) return seq_packederror(t);
+				s=&t->stack[t->sp++];
+				s->addr=p;
+				s->base=t->base;
+				s->count=0;
+				t->base=p=(uint8_t const *)pgm_read_word(&seq_subs[arg]);
+				break;
+			case SEQ_OP_RETURN:
+				if(!t->sp) return seq_packederror(t);
+				s=&t->stack[--t->sp];
+				p=s->addr;
+				t->base=s->base;
+				break;
+			case SEQ_OP_LABEL:
+				p++;
+				break;
+			case SEQ_OP_JUMP:
+				p=seq_findlabel(t->base, arg);
+				if(!p) return seq_packederror(t);
+				break;
+			default:	// SEQ_OP_END
+				return 0;
+		}
+	}
+
+	// time, 7 bits per byte, bit 7 is set on all bytes but the last
+	ticks=0;
+	do
+	{
+		b=pgm_read_byte(p++);
+		ticks=(ticks<<7)|(b&0x7F);
+	} while(b&0x80);
+
+	// mask of the servos that change, least significant byte first
+	changed=0;
+	for(i=0; i<SEQ_MASK_BYTES; i++)
+	{
+		changed|=(seq_mask_t)pgm_read_byte(p++)<<(8*i);
+	}
+
+	t->step_ease= (t->ease_array && t->step<t->length) ? pgm_read_byte(&(t->ease_array[t->step])) : t->ease;
+	t->step_ticks=ticks;
+	t->phase=0;
+
+	if(apply) servo_out_stage_begin();
+	for(i=0, bit=1; changed; i++, bit<<=1)
+	{
+		if(!(changed & bit)) continue;
+		changed&=~bit;
+
+		b=pgm_read_byte(p++);
+		if(b==SEQ_EXACT_CODE)
+		{
+			goal=pgm_read_word(p);
+			p+=2;
+		}
+		else if(b==SEQ_NP) goal=SERVO_NO_PULSE;
+		else if(b<SEQ_POS_NUM)
+		{
+			if(i>=seq_positions_count) continue;	// no position table for this servo
+			goal=pgm_read_word(&(seq_positions[i][b]));
 		}
+		else goal=(int16_t)b*10;
+
+		if(apply && (t->servos & bit)) seq_setgoal(i, goal);	// the other servos belong to other tracks
+	}
+	if(apply) servo_out_stage_commit();
+	t->next=p;
+	return 1;
+}
+
+// returns the start of the packed item (frame or opcode) after p
+static uint8_t const* seq_skipframe(uint8_t const *p)
+{
+	uint8_t i, op;
+	seq_mask_t changed=0;
+
+	if(pgm_read_byte(p)==SEQ_OP)
+	{
+		op=pgm_read_byte(p+1);
+		if(op==SEQ_OP_REPEAT || op==SEQ_OP_CALL || op==SEQ_OP_LABEL || op==SEQ_OP_JUMP) return p+3;
+		return p+2;
+	}
+
+	while(pgm_read_byte(p++)&0x80);
+	for(i=0; i<SEQ_MASK_BYTES; i++)
+	{
+		changed|=(seq_mask_t)pgm_read_byte(p++)<<(8*i);
+	}
+	for(; changed; changed>>=1)
+	{
+		if(!(changed&1)) continue;
+		if(pgm_read_byte(p++)==SEQ_EXACT_CODE) p+=2;
 	}
+	return p;
+}
+
+// finds SEQ_LABEL(label) in the stream starting at p, returns what follows it or 0
+static uint8_t const* seq_findlabel(uint8_t const *p, uint8_t label)
+{
+	uint8_t op;
+	for(;;)
+	{
+		if(pgm_read_byte(p)==SEQ_OP)
+		{
+			op=pgm_read_byte(p+1);
+			if(op==SEQ_OP_LABEL && pgm_read_byte(p+2)==label) return p+3;
+			if(op==SEQ_OP_END || op==SEQ_OP_RETURN) return 0;
+		}
+		p=seq_skipframe(p);
+	}
+}
+
+// This doesn't set the servo position directly, it just sets the goal of servo i (from 0)
+// All servo assignment other than SERVO_NO_PULSE take place at interrupt time in seq_dosequence()
+static void seq_setgoal(uint8_t i, int16_t goal)
+{
+	// a servo that turns around starts again from zero speed
+	if((goal>seq_current[i]) != (seq_goal[i]>seq_current[i]) || seq_goal[i]==seq_current[i]) seq_velocity[i]=0;
+	seq_start[i]=seq_current[i];
+	seq_goal[i]=goal;
+	if(seq_goal[i]!=seq_current[i]) seq_moving|=SEQ_SERVO(i+1);
+	// cutting off servo pulses is the only immediate servo assignment
+	if(goal==SERVO_NO_PULSE) servo_out_set(i+1,SERVO_NO_PULSE);
 }
 
 /**********************************************
-* This is the real time routine that executes the sequence
+* This is the real time routine that executes the sequences
 * This is called automatically by the realtime.c module every 1/100 of a second
 * (see the rt_dorealtime() function in that module).
 * Alternately if you do not want to use the realtime.c module, you can call this
@@ -165,81 +737,228 @@ void seq_setservopos(int16_t const array[][SERVO_NUM+1], uint8_t step)
 
 void seq_dosequence()
 {
-	// do nothing unless sequencer explicitly started
-	if(!sequence_started) return;
-	// sequence array pointer not set, return
-	if(!sequence_array) return;
-
 	// the first part of this function just updates the servo position
-	// towards the goal position at the maximum speed allowed
+	// towards the goal position at the maximum speed allowed.
+	// Only the servos that have not reached their goal are visited.
 	uint8_t i;
-	int16_t maxspeed;
 	int16_t delta;
-	for(i=0; i<SERVO_NUM; i++)
+	uint16_t elapsed, ticks;
+	seq_mask_t moving, bit;
+	seq_track_t* t;
+
+	// count down the step timers, seq_tempo/256 sequence ticks per real tick.
+	// The fraction left is carried to the next tick so the timing doesn't drift.
+	ticks=seq_tempo+seq_tempo_frac;
+	seq_tempo_frac=(uint8_t)ticks;
+	ticks>>=8;
+	for(t=seq_tracks; t<seq_tracks+SEQ_TRACK_NUM; t++)
 	{
-		maxspeed=servo_speed[i];			// read servo speed
-		delta=seq_goal[i]-seq_current[i];	// calculate difference between goal and current
-		if (delta==0) continue;				// if goal position already reached, nothing to do
+		if(t->timeout>ticks) t->timeout-=ticks;
+		else if(t->timeout)
+		{
+			t->late=ticks-t->timeout;	// taken from the next step
+			t->timeout=0;
+		}
+	}
 
-		// speed code 0 means no speed limit
-		// SERVO_NO_PULSE means waking up, we have no valid current position info
-		// so we must update it instantly too.
-		if (maxspeed==0 || seq_current[i]==SERVO_NO_PULSE)
+	moving=seq_moving;
+	if(moving)
+	{
+		// progress of the time based easings, one division per track
+		for(t=seq_tracks; t<seq_tracks+SEQ_TRACK_NUM; t++)
 		{
-			seq_current[i]=seq_goal[i];		// set current position=goal
-			servo_set(i+1, seq_current[i]); // update actual servo position
+			if(!t->started || t->step_ease<SEQ_EASE_LINEAR || t->step_ease>SEQ_EASE_INOUT) continue;
+			elapsed=t->step_ticks-t->timeout;
+			if(!t->timeout || elapsed>=t->step_ticks) t->phase=256;
+			else t->phase=((uint32_t)elapsed<<8)/t->step_ticks;
 		}
-		else	// get closer to goal maxspeed at a time
+
+		servo_out_stage_begin();	// all servo moves of this tick start in the same servo frame
+		for(i=0, bit=1; moving; i++, bit<<=1)
 		{
-			if(delta>0)
+			if(!(moving & bit)) continue;
+			moving&=~bit;
+
+			t=&seq_tracks[seq_owner[i]];
+			if(!t->started) continue;			// servos only move while their track runs
+
+			delta=seq_goal[i]-seq_current[i];	// calculate difference between goal and current
+			if (delta==0)						// if goal position already reached, nothing to do
+			{
+				seq_moving&=~bit;
+				continue;
+			}
+
+			// SERVO_NO_PULSE means waking up, we have no valid current position info
+			// so we must update it instantly too. A servo going to SERVO_NO_PULSE is
+			// already off, it must not be driven on its way there.
+			if (seq_current[i]==SERVO_NO_PULSE || seq_goal[i]==SERVO_NO_PULSE)
+			{
+				seq_current[i]=seq_goal[i];		// set current position=goal
+			}
+			else seq_current[i]=seq_nextpos(t, i, delta);
+			servo_out_set(i+1, seq_current[i]); // update actual servo position
+			if(seq_current[i]==seq_goal[i])
 			{
-				if(delta>maxspeed) seq_current[i]=seq_current[i]+maxspeed;
-				else seq_current[i]=seq_goal[i];
+				seq_moving&=~bit;
+				seq_velocity[i]=0;
 			}
+		}
+		servo_out_stage_commit();
+	}
+
+	// This second part now runs the sequence of each track
+	for(t=seq_tracks; t<seq_tracks+SEQ_TRACK_NUM; t++)
+	{
+		seq_dotrack(t);
+	}
+}
+
+// position of servo i for this tick, following the easing of its track
+static int16_t seq_nextpos(seq_track_t* t, uint8_t i, int16_t delta)
+{
+	int16_t maxspeed= t->speed ? t->speed[i] : 0;		// read servo speed
+	uint16_t phase, ease, distance, step;
+
+	switch(t->step_ease)
+	{
+		case SEQ_EASE_LINEAR:
+		case SEQ_EASE_IN:
+		case SEQ_EASE_OUT:
+		case SEQ_EASE_INOUT:
+			phase=t->phase;
+			if(phase>=256) return seq_goal[i];
+			// ease in is the first half of the in and out curve stretched, ease out the second half
+			if(t->step_ease==SEQ_EASE_IN) phase>>=1;
+			else if(t->step_ease==SEQ_EASE_OUT) phase=128+(phase>>1);
+			if(t->step_ease==SEQ_EASE_LINEAR) ease=phase;
 			else
 			{
-				if(delta<maxspeed) seq_current[i]=seq_current[i]-maxspeed;
-				else seq_current[i]=seq_goal[i];
+				// table interpolation, 4 phase units per table entry
+				ease=pgm_read_word(&seq_ease_table[phase>>2]);
+				ease+=((pgm_read_word(&seq_ease_table[(phase>>2)+1])-ease)*(phase&3))>>2;
+				if(t->step_ease==SEQ_EASE_IN) ease<<=1;
+				else if(t->step_ease==SEQ_EASE_OUT) ease=(ease<<1)-256;
 			}
+			return seq_start[i]+(int16_t)(((int32_t)(seq_goal[i]-seq_start[i])*ease)>>8);
 
-			servo_set(i+1, seq_current[i]); // update actual servo position
-		}
+		case SEQ_EASE_TRAPEZOID:
+			// speed code 0 means no speed limit
+			if(maxspeed==0) return seq_goal[i];
+			// accelerate by maxspeed/16 per tick, brake the same way when the
+			// braking distance v*v/2a reaches the distance left. Speeds are kept in 1/16 us.
+			distance= delta>0 ? delta : -delta;
+			if((uint32_t)seq_velocity[i]*seq_velocity[i] >= (uint32_t)distance*maxspeed*32)
+			{
+				if(seq_velocity[i]>maxspeed) seq_velocity[i]-=maxspeed;
+			}
+			else
+			{
+				seq_velocity[i]+=maxspeed;
+				if(seq_velocity[i]>(uint16_t)maxspeed<<4) seq_velocity[i]=(uint16_t)maxspeed<<4;
+			}
+			step=(seq_velocity[i]+8)>>4;
+			if(step==0) step=1;
+			if(step>=distance) return seq_goal[i];
+			return delta>0 ? seq_current[i]+step : seq_current[i]-step;
+
+		default:	// SEQ_EASE_SPEED, get closer to goal maxspeed at a time
+			// speed code 0 means no speed limit
+			if(maxspeed==0) return seq_goal[i];
+			if(delta>maxspeed) return seq_current[i]+maxspeed;
+			if(delta< -maxspeed) return seq_current[i]-maxspeed;
+			return seq_goal[i];
 	}
+}
 
-	// This second part now run the sequence
+static void seq_dotrack(seq_track_t* t)
+{
+	// do nothing unless sequencer explicitly started
+	if(!t->started) return;
+	if(!t->timeout==0) return; // wait until previous step has finished
 
-	if(!seq_timeout==0) return; // wait until previous step has finished
+	if(t->packed)
+	{
+		seq_dopacked(t);
+		return;
+	}
+	// sequence array pointer not set, return
+	if(!t->array && !t->gen) return;
 
 	// step has finished, go to next sequence step
-	if (sequence_step<sequence_length-1) // normal step
+	if (t->step<t->length-1) // normal step
 	{
 		{
-			seq_setservopos(sequence_array, sequence_step); 					// put servos in position
-			seq_timeout=pgm_read_word(&(sequence_array[sequence_step][0]));		// restart timer with step time value
-			sequence_step++;													// advance to next step
+			seq_setservopos(t, t->step); 								// put servos in position
+			seq_steptimeout(t);											// restart timer with step time value
+			t->step++;													// advance to next step
 		}
 	}
 	else // last step
 	{
 		// if last step time is zero, means stop
-
-		if(!pgm_read_word(&(sequence_array[sequence_length-1][0])))
+		seq_setservopos(t, t->length-1);
+		if(!t->step_ticks)
 		{
-			seq_setservopos(sequence_array, sequence_length-1);
 			// ### this has a problem, means that the sequence is stopped before the servos
 			// actually reach their goal position. The last step is not "performed", except
 			// if it's a no pulse (_NP) servo assignment
-			sequence_started=0;
-			sequence_step=0;
+			t->started=0;
+			t->step=0;
 			// call the completion callback
-			if(seq_completion_callback) seq_completion_callback();
+			if(t->completion_callback) t->completion_callback();
 		}
 		else // it's a looping sequence, just rewind sequence step to 0
 		{
-			seq_setservopos(sequence_array, sequence_length-1);
-			seq_timeout=pgm_read_word(&(sequence_array[sequence_length-1][0]));
-			sequence_step=0;
+			seq_steptimeout(t);
+			t->step=0;
 		}
 	}
 }
 
+// returns 1 if the packed sequence ends (or is wrong) after the frame just played,
+// by running the control flow that follows it on a copy of the track
+static uint8_t seq_packedends(seq_track_t const* t)
+{
+	seq_track_t peek=*t;
+
+	return !seq_nextpacked(&peek, 0);
+}
+
+// next step of a packed sequence
+static void seq_dopacked(seq_track_t* t)
+{
+	uint8_t played;
+
+	played=seq_nextpacked(t, 1);
+	// SEQ_END after a timed frame, it's a looping sequence, start again
+	// (after a zero time frame or an error it stops)
+	if(!played && t->step_ticks)
+	{
+		seq_rewind(t);
+		played=seq_nextpacked(t, 1);
+	}
+	if(played)
+	{
+		// frames played through a SEQ_JUMP loop go past SEQ_FRAMES, the count stops there
+		// so that it doesn't wrap back into the ease array
+		if(t->step<t->length) t->step++;
+		seq_steptimeout(t);
+		// like a sequence_t, the sequence stops when its last frame has no time
+		// (a zero time frame in the middle is just followed by the next frame at the next tick)
+		if(t->step_ticks || !seq_packedends(t)) return;
+	}
+	// same problem as for sequence_t, the servos may not have reached the last positions
+	t->started=0;
+	seq_rewind(t);
+	// call the completion callback
+	if(t->completion_callback) t->completion_callback();
+}
+
+// starts the timer of the step, less what the previous step ran over at a fast tempo
+static void seq_steptimeout(seq_track_t* t)
+{
+	if(t->step_ticks>t->late) t->timeout=t->step_ticks-t->late;
+	else t->timeout= t->step_ticks ? 1 : 0;
+	t->late=0;
+}
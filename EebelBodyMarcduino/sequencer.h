@@ -4,16 +4,36 @@
  *  Created on: Jul 10, 2012
  *      Author: Marc Verdiell
  *
- *  A servo sequencer. Works in conjunction with servo.c and realtime.c modules
+ *  A servo sequencer. Works in conjunction with servo_out.c and realtime.c modules
  *  The sequence is held on a matrix, each line representing a "frame" or step
  *  The first element of the frame is the length of the step in 1/100 sec.
- *  Then the position of all servos follows. Currently all servos up to SERVO_NUM
+ *  Then the position of all servos follows. Currently all servos up to SEQ_SERVO_NUM
  *  are involved in the sequence, I could change this later.
+ *  SEQ_SERVO_NUM is SERVO_NUM, plus the PCA9685 channels if enabled (see servo_out.h).
  *  Use _NP for no pulse if you want the servo powered off, like done at the end here
  *  in the example.
  *  On the last step, a 0 in the time will stop the sequence.
  *  A non zero time will cause a loop back to the first step.
  *
+ *  Several sequences can run at once on separate tracks (SEQ_TRACK_NUM).
+ *  Each track owns a subset of the servos (a mask built with SEQ_SERVO(n)),
+ *  and has its own speed table, step, step countdown and completion callback.
+ *  Only the servos in its mask are moved by a track, the other columns of the
+ *  sequence are ignored.
+ *  Conflicts: the last track loaded wins. Loading a sequence takes the servos
+ *  of its mask away from the other tracks, and a track left without servos is stopped
+ *  (its completion callback is called).
+ *  The seq_xxx() functions without _track_ work on SEQ_TRACK_MAIN with all servos,
+ *  as the sequencer always did, so they preempt everything else.
+ *
+ *  Each step can pick how the servos move to their new position (SEQ_EASE_xxx):
+ *  SEQ_EASE_SPEED moves at the constant speed of the speed array (the default),
+ *  SEQ_EASE_LINEAR, _IN, _OUT and _INOUT spread the move over the step time following
+ *  an integer curve in program memory, and SEQ_EASE_TRAPEZOID ramps up to the speed
+ *  of the speed array and back down, in 16 ticks (0.16 s).
+ *  Call seq_seteasing() or seq_loadeasing() after seq_loadsequence(), loading a
+ *  sequence goes back to SEQ_EASE_SPEED.
+ *
  */
 
 
@@ -39,6 +59,7 @@
 	};
 
 	// optionally define a max speed for servos, 0 = max speed
+	// the sequencer keeps a pointer to it, so make it global (or static)
 	int16_t servo_dance_speed[]={50,20,0,20};
 
 
@@ -51,13 +72,193 @@
 	To stop it:
 	seq_stopsequence();
 
+	To ease every step in and out, or to pick the easing of each step
+	(one entry per sequence step, in program memory too):
+
+	seq_seteasing(SEQ_EASE_INOUT);
+
+	uint8_t const servo_dance_easing[] PROGMEM={SEQ_EASE_LINEAR, SEQ_EASE_INOUT, ...};
+	seq_loadeasing(servo_dance_easing);
+
+	Packed sequences
+	Most frames only move a few servos, so a sequence can also be stored as a byte stream
+	holding only what changes (seq_packed_t, see panel_dance in panel_sequences.h).
+	It starts with SEQ_FRAMES(number of frames played), then each frame is:
+	- the time, SEQ_T1(t) for t<128, SEQ_T2(t) for 128<=t<16384, SEQ_T3(t) from 16384 to 65535
+	  (always the shortest one, a time never starts with the SEQ_OP byte 0x80)
+	- SEQ_M(mask), the servos that change in this frame, bit 0 is servo 1
+	- one position per servo in the mask, in servo order:
+	  SEQ_US(us) for a pulse in us, 30 to 2530 in steps of 10 us,
+	  SEQ_CLOSE, SEQ_OPEN or SEQ_MID to use the position table of that servo (seq_loadpositions()),
+	  SEQ_NP for no pulse, or SEQ_EXACT(us) for any other pulse value (3 bytes).
+	The other servos keep their position. The stream is decoded one frame at a time
+	by the sequencer, and the first and last frame rules are the same as above.
+	The stream ends with SEQ_END, and can hold control flow between frames:
+	- SEQ_REPEAT(n) ... SEQ_END_REPEAT plays the frames in between n times
+	- SEQ_CALL(n) plays sub-sequence n of the table given to seq_loadsubsequences(),
+	  a stream of frames without SEQ_FRAMES ending with SEQ_RETURN
+	- SEQ_LABEL(n) ... SEQ_JUMP(n) goes back (or forward) to the label, in the same stream,
+	  a loop with a jump never ends so it is stopped with seq_stopsequence() or another sequence
+	Repeats and calls can be nested SEQ_STACK_DEPTH deep. SEQ_FRAMES counts the frames
+	as they are played, repeats unrolled, it sets the ease array length. The frames a jump
+	loop plays past it use the seq_seteasing() easing. The last frame is the one SEQ_END follows.
+
+	seq_packed_t const servo_dance_packed PROGMEM=
+	{
+			SEQ_FRAMES(3),
+			// time		servos		positions
+			SEQ_T1(50),	SEQ_M(0x00F), SEQ_US(1000), SEQ_US(1000), SEQ_US(1000), SEQ_US(1000),
+			SEQ_T1(50),	SEQ_M(0x001), SEQ_OPEN,
+			SEQ_T1(0),	SEQ_M(0x00F), SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP,
+			SEQ_END
+	};
+
+	Servo 1 waving 5 times, using a sub-sequence:
+
+	seq_packed_t const wave PROGMEM=
+	{
+			SEQ_T1(30),	SEQ_M(0x001), SEQ_OPEN,
+			SEQ_T1(30),	SEQ_M(0x001), SEQ_CLOSE,
+			SEQ_RETURN
+	};
+	uint8_t const * const subs[] PROGMEM={wave};
+
+	seq_packed_t const servo_wave_packed PROGMEM=
+	{
+			SEQ_FRAMES(11),
+			SEQ_REPEAT(5), SEQ_CALL(0), SEQ_END_REPEAT,
+			SEQ_T1(0),	SEQ_M(0x001), SEQ_NP,
+			SEQ_END
+	};
+
+	seq_loadsubsequences(subs, SEQ_SIZE(subs));
+
+	seq_loadpacked(servo_dance_packed);
+	seq_startsequence();
+
+	SEQ_PACKED_SAVED(servo_dance_packed) gives the flash saved compared to a sequence_t.
+
+	Generated sequences
+	Waves and other simple patterns are computed frame by frame instead of stored,
+	from a seq_gen_t in program memory (see panel_fast_wave_gen in panel_sequences.h):
+
+	seq_gen_t const servo_wave_gen PROGMEM=
+	{
+			SEQ_GEN_WAVE, SEQ_GEN_BOUNCE,		// pattern, flags
+			0x00F,								// servos 1 to 4, in servo order
+			2,									// cycles
+			20, 30, 0, 50,						// times of the first, pattern, hold and closing frames
+			0									// open/close table, 0 for the seq_loadpositions() table
+	};
+
+	seq_loadgenerator(&servo_wave_gen);
+	seq_startsequence();
+
+	The first frame closes the servos of the mask, then come the pattern cycles, a closing frame
+	and a no pulse frame that ends the sequence. Two servos in a SEQ_GEN_WAVE make a ping-pong.
+
+	Tempo
+	seq_settempo() changes the playback rate of all the tracks, to follow a song played a bit
+	faster or slower. It's 8.8 fixed point, SEQ_TEMPO_NORMAL (256) plays the times of the sequences,
+	512 twice as fast, 0 holds the steps. It can change while a sequence runs.
+	Only the step times are scaled, the speeds of the speed arrays are not.
+
+	To run a second sequence on servos 5 to 7 only, alongside the main one:
+
+	seq_track_loadsequence(1, arm_tool, SEQ_SIZE(arm_tool), SEQ_SERVO(5)|SEQ_SERVO(6)|SEQ_SERVO(7));
+	seq_track_loadspeed(1, arm_tool_speed);
+	seq_track_startsequence(1);
+
 **************************************/
 
 #ifndef SEQUENCER_H_
 #define SEQUENCER_H_
 
 #include <stdint.h>
-#include "servo.h" // for SERVO_NUM
+#include "servo_out.h" // for SERVO_OUT_NUM
+
+#define SEQ_SERVO_NUM SERVO_OUT_NUM	// number of servos in a sequence step
+#define SEQ_TRACK_NUM 4				// number of sequences that can run at the same time, all stepped from the 10 ms frame tick
+								// (main track plus the SE30, SE33 and SE34 tool tracks of main.c)
+#define SEQ_TRACK_MAIN 0			// track used by the seq_xxx() functions without _track_
+
+// servo masks, bit 0 is servo 1
+#if SEQ_SERVO_NUM>32
+#error "sequencer servo masks are limited to 32 servos"
+#elif SEQ_SERVO_NUM>16
+typedef uint32_t seq_mask_t;
+#else
+typedef uint16_t seq_mask_t;
+#endif
+
+// easing, how servos move to the goal of a step
+#define SEQ_EASE_SPEED		0	// constant speed from the speed array, 0 = jump
+#define SEQ_EASE_LINEAR		1	// reach the goal at the end of the step, constant speed
+#define SEQ_EASE_IN			2	// reach the goal at the end of the step, start slow
+#define SEQ_EASE_OUT		3	// reach the goal at the end of the step, end slow
+#define SEQ_EASE_INOUT		4	// reach the goal at the end of the step, start and end slow
+#define SEQ_EASE_TRAPEZOID	5	// accelerate to the speed array speed and brake before the goal
+
+// packed sequences
+#define SEQ_POS_NUM 3				// symbolic positions per servo
+#define SEQ_CLOSE	0
+#define SEQ_OPEN	1
+#define SEQ_MID		2
+#define SEQ_EXACT_CODE	0xFE
+#define SEQ_NP		0xFF
+
+// control flow, SEQ_OP then the opcode and its argument if any
+#define SEQ_OP				0x80
+#define SEQ_OP_END			0
+#define SEQ_OP_REPEAT		1
+#define SEQ_OP_END_REPEAT	2
+#define SEQ_OP_CALL			3
+#define SEQ_OP_RETURN		4
+#define SEQ_OP_LABEL		5
+#define SEQ_OP_JUMP			6
+#define SEQ_STACK_DEPTH		3		// nested repeats and calls per track
+#define SEQ_MAX_OPS			16		// opcodes run before a frame, more means a loop without frames
+
+#define SEQ_END			SEQ_OP, SEQ_OP_END
+#define SEQ_REPEAT(n)	SEQ_OP, SEQ_OP_REPEAT, (uint8_t)(n)
+#define SEQ_END_REPEAT	SEQ_OP, SEQ_OP_END_REPEAT
+#define SEQ_CALL(n)		SEQ_OP, SEQ_OP_CALL, (uint8_t)(n)
+#define SEQ_RETURN		SEQ_OP, SEQ_OP_RETURN
+#define SEQ_LABEL(n)	SEQ_OP, SEQ_OP_LABEL, (uint8_t)(n)
+#define SEQ_JUMP(n)		SEQ_OP, SEQ_OP_JUMP, (uint8_t)(n)
+
+#define SEQ_FRAMES(n)	(uint8_t)(n)
+#define SEQ_T1(t)		(uint8_t)(t)
+#define SEQ_T2(t)		(uint8_t)(0x80|((t)>>7)), (uint8_t)((t)&0x7F)
+#define SEQ_T3(t)		(uint8_t)(0x80|((uint16_t)(t)>>14)), (uint8_t)(0x80|(((t)>>7)&0x7F)), (uint8_t)((t)&0x7F)
+#define SEQ_US(us)		(uint8_t)((us)/10)
+#define SEQ_EXACT(us)	SEQ_EXACT_CODE, (uint8_t)(us), (uint8_t)((uint16_t)(us)>>8)
+#define SEQ_POSITION(close, open)	{close, open, ((close)+(open))/2}
+
+#define SEQ_MASK_BYTES ((SEQ_SERVO_NUM+7)/8)
+#if SEQ_MASK_BYTES==1
+#define SEQ_M(m)	(uint8_t)(m)
+#elif SEQ_MASK_BYTES==2
+#define SEQ_M(m)	(uint8_t)(m), (uint8_t)((m)>>8)
+#elif SEQ_MASK_BYTES==3
+#define SEQ_M(m)	(uint8_t)(m), (uint8_t)((m)>>8), (uint8_t)((uint32_t)(m)>>16)
+#else
+#define SEQ_M(m)	(uint8_t)(m), (uint8_t)((m)>>8), (uint8_t)((uint32_t)(m)>>16), (uint8_t)((uint32_t)(m)>>24)
+#endif
+
+#define SEQ_TEMPO_NORMAL	0x100	// seq_settempo(), 8.8 fixed point
+
+// generated sequences
+#define SEQ_GEN_WAVE	0		// one servo open at a time, walking along the mask
+#define SEQ_GEN_FILL	1		// the servos open one by one, then close one by one in the same order
+#define SEQ_GEN_ANTS	2		// every other servo open, alternating
+#define SEQ_GEN_REVERSE	0x01	// flag, start from the last servo of the mask
+#define SEQ_GEN_BOUNCE	0x02	// flag, a SEQ_GEN_WAVE comes back after an all closed frame
+
+#define SEQ_PACKED_SAVED(A) seq_packed_saved(A, sizeof(A))
+
+#define SEQ_SERVO(n) ((seq_mask_t)1<<((n)-1))
+#define SEQ_ALL_SERVOS ((seq_mask_t)(0xFFFFFFFFUL>>(32-SEQ_SERVO_NUM)))
 
 
 // define your servo frames here
@@ -66,9 +267,25 @@
 #define _NP SERVO_NO_PULSE
 #define SEQ_SIZE(A) (sizeof(A) / sizeof(A[0]))
 
-typedef int16_t sequence_t[][SERVO_NUM +1];
-typedef int16_t (*sequence_t_ptr)[SERVO_NUM +1];
-typedef int16_t speed_t[SERVO_NUM];
+typedef int16_t sequence_t[][SEQ_SERVO_NUM +1];
+typedef int16_t (*sequence_t_ptr)[SEQ_SERVO_NUM +1];
+typedef int16_t speed_t[SEQ_SERVO_NUM];
+typedef uint8_t seq_packed_t[];
+typedef int16_t seq_positions_t[][SEQ_POS_NUM];
+
+// a generated sequence, times in 1/100s
+typedef struct
+{
+	uint8_t pattern;							// SEQ_GEN_xxx
+	uint8_t flags;								// SEQ_GEN_REVERSE, SEQ_GEN_BOUNCE
+	seq_mask_t panels;							// servos of the pattern, bit 0 is servo 1
+	uint8_t repeats;							// number of pattern cycles, 255 frames max
+	uint8_t lead;								// time of the first frame, all closed
+	uint8_t period;								// time of each pattern frame
+	uint8_t hold;								// time of the all open frame of a SEQ_GEN_FILL
+	uint8_t tail;								// time of the closing frame
+	int16_t const (*positions)[SEQ_POS_NUM];	// open/close table, 0 for the seq_loadpositions() table
+} seq_gen_t;
 
 // public
 void seq_init();
@@ -76,14 +293,38 @@ void seq_add_completion_callback(void(*usercallback)());
 void seq_remove_completion_callback();
 void seq_loadspeed(speed_t speedarray);
 void seq_resetspeed();
-void seq_loadsequence(int16_t const array[][SERVO_NUM+1], uint8_t length);
+void seq_loadsequence(int16_t const array[][SEQ_SERVO_NUM+1], uint8_t length);
+void seq_loadpacked(uint8_t const packed[]);
+void seq_loadpositions(int16_t const table[][SEQ_POS_NUM], uint8_t count);
+void seq_loadgenerator(seq_gen_t const *gen);
+void seq_settempo(uint16_t tempo);
+uint16_t seq_gettempo();
+void seq_loadsubsequences(uint8_t const * const table[], uint8_t count);
+int16_t seq_packed_saved(uint8_t const packed[], uint16_t size);
 void seq_startsequence();
 void seq_stopsequence();
 void seq_restartsequence();
+void seq_jumptostep(uint8_t step);
+void seq_seteasing(uint8_t easing);
+void seq_loadeasing(uint8_t const easing[]);
+
+// same on a given track, servos is the mask of servos the track takes over
+void seq_track_add_completion_callback(uint8_t track, void(*usercallback)());
+void seq_track_remove_completion_callback(uint8_t track);
+void seq_track_loadspeed(uint8_t track, speed_t speedarray);
+void seq_track_resetspeed(uint8_t track);
+void seq_track_seteasing(uint8_t track, uint8_t easing);
+void seq_track_loadeasing(uint8_t track, uint8_t const easing[]);
+void seq_track_loadsequence(uint8_t track, int16_t const array[][SEQ_SERVO_NUM+1], uint8_t length, seq_mask_t servos);
+void seq_track_loadpacked(uint8_t track, uint8_t const packed[], seq_mask_t servos);
+void seq_track_loadgenerator(uint8_t track, seq_gen_t const *gen, seq_mask_t servos);
+void seq_track_startsequence(uint8_t track);
+void seq_track_stopsequence(uint8_t track);
+void seq_track_restartsequence(uint8_t track);
+void seq_track_jumptostep(uint8_t track, uint8_t step);
+uint8_t seq_track_running(uint8_t track);
 
 // private
 void seq_dosequence();
-void seq_jumptostep(uint8_t step);
-void seq_setservopos(int16_t const array[][SERVO_NUM+1], uint8_t step);
 
 #endif /* SEQUENCER_H_ */
@@ -23,6 +23,20 @@
  *		Added preliminary support for servo reversing
  *		Right now all servos reversed. I'll need to add 1:1 reversing with EEPROM control later
  *		(#define _REVERSE_SERVOS_ if you want them reversed)
+ *
+ *		Revised: Oct 19, 2026
+ *		Concurrent start: all active outputs are raised together at the start of a fixed
+ *		20 ms frame (TIMER1_COMPA_vect), then ended in pulse length order from a sorted
+ *		schedule (TIMER1_COMPB_vect). The RC input is captured over the whole frame.
+ *		The bit masks and pulse ends (timer reloads) are computed in servo_init() and
+ *		servo_set(), and the schedule holds the start mask of each port, so each edge is
+ *		a single AND (end) and each port a single OR (start) in the interrupts.
+ *		servo_value[] and servo_reload[] are now a staging buffer: the live schedule is
+ *		only rebuilt from it when no writer is staging, so a 16-bit
+ *		value is never read half written and servos moved together start together.
+ *		The schedule is double buffered: the last servo_stage_commit() builds the next one
+ *		with interrupts on, and the frame start interrupt only swaps it in, so it stays short
+ *		and does not hold off the suart bit interrupts.
  */
 
 #include "servo.h"
@@ -40,7 +54,9 @@
 // global variables for the servo arrays
 uint16_t servo_value[12];			// pulse value in ms, -1 is no pulse
 uint8_t servo_pin[12];				// pins to which servos are connected
+uint8_t servo_mask[12];				// bit mask of the pins in their port, computed from servo_pin[]
 volatile uint8_t* servo_port[12];	// port addresses to which servos pins are connected
+uint16_t servo_reload[12];			// pulse end in counter ticks from the frame start (reversing applied), 0xFFFF if no pulse
 /*
 //Eebel  END
 uint16_t servo_open[12];			// pulse value in ms, -1 is no pulse
@@ -50,17 +66,42 @@ uint16_t servo_close[12];			// pulse value in ms, -1 is no pulse
 
 // only if compiled with rc input switch
 #ifdef SERVO_RCINPUT
-volatile int16_t servo_rcbegin;
-volatile int16_t servo_rcend;
+volatile uint16_t servo_rcbegin;	// counter values, the counter wraps at SERVO_FRAME
+volatile uint16_t servo_rcend;
 volatile uint8_t servo_gotpulse;
 volatile uint8_t servo_rctimeout;
 volatile uint8_t servo_rcvalid;
+volatile uint8_t servo_rcdeferred;	// the capture was left running over one frame start already
 volatile int16_t servo_rctemp;
 int16_t servo_rcpulse;
 #endif
 
+// pulse end schedule, shortest pulse first
+typedef struct
+{
+	uint8_t order[12];				// servo index
+	uint16_t end[12];				// pulse end in counter ticks from the frame start, 0xFFFF if no pulse
+	volatile uint8_t* rise_port[SERVO_NUM];	// ports with active servos, and the mask to start them
+	uint8_t rise_mask[SERVO_NUM];
+	uint8_t rise_ports;				// number of ports used
+	uint8_t active;					// number of servos pulsed in the frame
+} servo_schedule_t;
+
+// the interrupts use the live schedule, servo_stage_commit() builds the next one
+// and the frame start swaps them
+static servo_schedule_t servo_schedules[2];
+static servo_schedule_t* servo_live=&servo_schedules[0];
+static servo_schedule_t* servo_next=&servo_schedules[1];
+static uint16_t servo_frame_start;	// counter value when the pulses were started
+static volatile uint8_t servo_changed;	// set by servo_set(), cleared when a schedule is built from it
+static volatile uint8_t servo_staging;	// number of writers between servo_stage_begin() and servo_stage_commit()
+static volatile uint8_t servo_building;	// servo_schedule() is running, maybe interrupted by another writer
+static volatile uint8_t servo_ready;	// servo_next is complete, swap it in at the frame start
+
+static void servo_schedule();
+
 // private global variable updated in interrupt routine
-static volatile uint8_t current_servo;
+static volatile uint8_t current_servo;	// schedule entry of the next pulse to end
 
 /************************************************
  * Start the servo pulses
@@ -78,7 +119,11 @@ void servo_init()
 	for(i=0; i<=11; i++)
 	{
 		servo_value[i]=SERVO_NO_PULSE; // manipulate directly (could call servo_set() instead)
+		servo_reload[i]=0xFFFF;
+		servo_live->order[i]=i;
 	}
+	servo_live->active=0;
+	servo_changed=1;
 
 	// store servo PORTx register addresses in servo_port array
 	servo_port[0]=&SERVO1_PORT;
@@ -108,6 +153,13 @@ void servo_init()
 	servo_pin[10]= SERVO11_PIN;
 	servo_pin[11]= SERVO12_PIN;
 
+	// the interrupts use bit masks, so no shifts there
+	for(i=0; i<=11; i++)
+	{
+		servo_mask[i]=_BV(servo_pin[i]);
+	}
+	servo_schedule();
+
 
 /*
 	//Eebel Start
@@ -144,22 +196,22 @@ void servo_init()
 	// Set all servo outputs pins to 0;
 	for(i=0; i<SERVO_NUM; i++)
 	{
-		clear_bit(*servo_port[i], servo_pin[i]);
+		*servo_port[i] &= ~servo_mask[i];
 	}
 	// Set all servo pins to output mode
 	for(i=0; i<SERVO_NUM; i++)
 	{
-		set_bit(servo_DDR(*servo_port[i]), servo_pin[i]);
+		servo_DDR(*servo_port[i]) |= servo_mask[i];
 		//maybe elike this?
 		//set_bit(servo_DDR(*servo_port[i]), servo_pin[i], servo_open[i], servo_close[i]);
 	}
 	// Reset all servo values to SERVO_NO_PULSE
 
 	// Timer1 setup, used for timing servo outputs
-	TIMSK &= ~_BV(TOIE1); 			// Disable overflow interrupts for now (TIMER1_OVF_vect)
-	current_servo = SERVO_NUM;		// start with servo pause
-	TCCR1A =0; 						// Simple up counting operation until overflow
-	TCNT1= -(SERVO_PULSE_PAUSE);	// start counter at -16000 us
+	TIMSK &= ~(_BV(OCIE1A) | _BV(OCIE1B));	// Disable compare interrupts for now (TIMER1_COMPA_vect, TIMER1_COMPB_vect)
+	TCCR1A =0; 						// CTC mode with OCR1A as TOP (WGM12 is set in servo_start())
+	OCR1A = SERVO_FRAME-1;			// counter wraps every 20 ms, the wrap is the frame start
+	TCNT1=0;
 
 	// further init if RC input is enabled
 	#ifdef SERVO_RCINPUT
@@ -175,17 +227,18 @@ void servo_init()
 /************************************************
  * Start the servo pulses
  * Set counter1 to 0.5 us ticks on 16 MHz clock
- * Enable overflow interrupts
- * Start by counting a long pause
+ * Enable frame start interrupts
+ * Start at the end of a frame, pulses begin on the next tick
  * *********************************************/
 void servo_start()
 {
 	// Uses clock input divided by 8, 0.5 microsecond/tick
-	current_servo = SERVO_NUM;		// start with servo pause
-	TCNT1= -(SERVO_PULSE_PAUSE);	// start counter at -16000 us
-	TIMSK |= _BV(TOIE1); 			// Enable overflow interrupts
+	TCNT1= SERVO_FRAME-1;			// frame start on the next count
+	set_bit(TIFR, OCF1A);			// clear pending compare flags (by setting them to 1)
+	set_bit(TIFR, OCF1B);
+	TIMSK |= _BV(OCIE1A); 			// Enable frame start interrupts
 	sei();							// enable global interrupts
-	TCCR1B |= _BV(CS11); 			// Launch timer, pre-scaler div clock by 8, gives 0.5 us ticks at 16 MHz
+	TCCR1B |= _BV(WGM12) | _BV(CS11); // Launch timer in CTC mode, pre-scaler div clock by 8, gives 0.5 us ticks at 16 MHz
 }
 
 /*****************************
@@ -197,9 +250,9 @@ void servo_stop()
 	// Set all servo output to 0;
 	for(i=0; i<SERVO_NUM; i++)
 	{
-		clear_bit(*servo_port[i], servo_pin[i]);
+		*servo_port[i] &= ~servo_mask[i];
 	}
-	TIMSK &= ~_BV(TOIE1); 	// Disable overflow interrupts
+	TIMSK &= ~(_BV(OCIE1A) | _BV(OCIE1B)); 	// Disable compare interrupts
 	TCCR1B = 0; 			// Stop timer
 }
 
@@ -221,19 +274,32 @@ void servo_set(uint8_t servo, int16_t time)
 	// servo must be 1 to SERVO_NUM
 	if(servo==0 || servo>SERVO_NUM) return;
 
+	servo_stage_begin();	// so no schedule is built from a half written value
+
 	// time=SERVO_NO_PULSE means no output
 	if(time<=SERVO_NO_PULSE)
 	{
 		servo_value[servo-1]=SERVO_NO_PULSE;
-		return;
+		servo_reload[servo-1]=0xFFFF;
 	}
+	else
+	{
+		// time will be trimmed to (SERVO_PULSE_MAX - SERVO_PULSE_MIN)
+		if(time>SERVO_PULSE_MAX) time=SERVO_PULSE_MAX;
+		if(time<SERVO_PULSE_MIN) time=SERVO_PULSE_MIN;
 
-	// time will be trimmed to (SERVO_PULSE_MAX - SERVO_PULSE_MIN)
-	if(time>SERVO_PULSE_MAX) time=SERVO_PULSE_MAX;
-	if(time<SERVO_PULSE_MIN) time=SERVO_PULSE_MIN;
+		// multiply by two to account for counter ticks of 0.5us
+		servo_value[servo-1]=2*time;
+#ifdef _REVERSE_SERVOS_
+		// inverse pulse length, servo values are stored as twice their us value
+		servo_reload[servo-1]=4*SERVO_PULSE_CENTER-2*time;
+#else
+		servo_reload[servo-1]=2*time;
+#endif
+	}
+	servo_changed=1;		// servo_stage_commit() builds the next schedule, the frame start swaps it in
 
-	// multiply by two to account for counter ticks of 0.5us
-	servo_value[servo-1]=2*time;
+	servo_stage_commit();
 }
 
 /*****************************************************
@@ -247,80 +313,207 @@ void servo_set(uint8_t servo, int16_t time)
  *****************************************************/
 int16_t servo_read(uint8_t servo)
 {
+	uint8_t sreg;
+	uint16_t value;
+
 	// servo must be 1 to SERVO_NUM
 	if(servo==0 || servo>SERVO_NUM) return 0;
 
+	// 16 bit read, servo_set() can be called from the realtime interrupt
+	sreg=SREG;
+	cli();
+	value=servo_value[servo-1];
+	SREG=sreg;
+
 	// time=SERVO_NO_PULSE means no output
-	if(servo_value[servo-1]==SERVO_NO_PULSE)
+	if(value==(uint16_t)SERVO_NO_PULSE)
 	{
 		return SERVO_NO_PULSE;
 	}
 
 	// Divide by two to account for 0.5us counter ticks
 	// subtract minimum pulse width
-	return (servo_value[servo-1]/2);
+	return (value/2);
+}
+
+/*****************************************************
+ * Staged servo updates, see servo.h
+ * The counter is only read by servo_stage_commit(), to build
+ * the next schedule when the last writer is done.
+ * An interrupt that stages in the middle of a main loop
+ * increment or decrement always restores the count before
+ * returning, so plain increments are safe here.
+ *****************************************************/
+void servo_stage_begin()
+{
+	servo_staging++;
+}
+
+void servo_stage_commit()
+{
+	if(servo_staging) servo_staging--;
+	if(!servo_staging && servo_changed) servo_schedule();
 }
 
 
 
 
 /******************************************************
- * Counter1 Overflow interrupt
- * At each iteration, sets the timer to the
- * next servo pulse length as set in the global variable
- * servo_value[]
- * A value of 0 in the servo means no pulse is put out
+ * Build a pulse end schedule from servo_reload[]
+ * Insertion sort on pulse length, starting from the order of the
+ * live schedule, so it is usually a single pass.
+ * Servos without pulse sort last (0xFFFF) and are not counted
+ * in active.
+ * Then collects the port/mask pairs that start the pulses.
  ***************************************************/
-ISR(TIMER1_OVF_vect)
+static void servo_build(servo_schedule_t* next, servo_schedule_t const* live)
 {
-	// first end the current pulse except if in pause
-	if(current_servo>=SERVO_NUM) // we were doing the long pause
-	{
-		// if RC reading, stop and read the input capture after the long pause
-		#ifdef SERVO_RCINPUT
-		servo_doRCread_end();
-		#endif
+	uint8_t i, j, s;
+	uint16_t end;
 
-		current_servo=0; // restart at first servo
+	next->active=0;
+	for(i=0; i<SERVO_NUM; i++)
+	{
+		s=live->order[i];
+		end=servo_reload[s];
+		if(end!=0xFFFF) next->active++;
+		for(j=i; j>0 && next->end[j-1]>end; j--)
+		{
+			next->order[j]=next->order[j-1];
+			next->end[j]=next->end[j-1];
+		}
+		next->order[j]=s;
+		next->end[j]=end;
 	}
-	else // normal case, end the current servo pulse before starting the next one
+
+	next->rise_ports=0;
+	for(i=0; i<next->active; i++)
 	{
-		clear_bit(*servo_port[current_servo], servo_pin[current_servo]);
-		// goto next servo
-		current_servo++;
+		s=next->order[i];
+
+		// merge servos on the same port, so they start with one write
+		for(j=0; j<next->rise_ports && next->rise_port[j]!=servo_port[s]; j++);
+		if(j==next->rise_ports)
+		{
+			next->rise_port[j]=servo_port[s];
+			next->rise_mask[j]=0;
+			next->rise_ports++;
+		}
+		next->rise_mask[j] |= servo_mask[s];
 	}
+}
+
+/******************************************************
+ * Build servo_next when the last writer commits, with interrupts on.
+ * A writer interrupting the build only flags its change, and the
+ * build it interrupted starts over. servo_ready stays clear until
+ * a build completes with no change behind it, so the frame start
+ * never swaps in a half built schedule.
+ ***************************************************/
+static void servo_schedule()
+{
+	uint8_t sreg=SREG;
 
-	// now start the next one except if it's time for pause
-	if(current_servo>=SERVO_NUM) // we've reached the pause
+	cli();
+	if(servo_building)
 	{
-		TCNT1= -(SERVO_PULSE_PAUSE); // load the counter with long pause value
+		SREG=sreg;
+		return;
+	}
+	servo_building=1;
+	servo_ready=0;
+	for(;;)
+	{
+		servo_changed=0;
+		SREG=sreg;
+		servo_build(servo_next, servo_live);
+		cli();
+		if(!servo_changed) break;
+	}
+	servo_ready=1;
+	servo_building=0;
+	SREG=sreg;
+}
 
-		// if RC reading, start the input capture during the pause
-		#ifdef SERVO_RCINPUT
+/******************************************************
+ * Counter1 Compare A interrupt, start of the servo frame
+ * The counter wraps every SERVO_FRAME ticks.
+ * Raises all active outputs together, then arms Compare B
+ * for the shortest pulse. Pulse ends are timed from the counter
+ * value read after the outputs are up, so rebuilding the
+ * schedule does not shorten the pulses.
+ ***************************************************/
+ISR(TIMER1_COMPA_vect)
+{
+	uint8_t i;
+	servo_schedule_t* sched;
+
+	// if RC reading, read the input capture of the last frame and restart it
+	// unless a pulse that started at the end of the frame is still being timed.
+	// That waits one frame at most, so a lost falling edge still counts as a timeout.
+	#ifdef SERVO_RCINPUT
+	if(bit_is_clear(TIMSK, ICIE1) || bit_is_set(TCCR1B, ICES1) || servo_rcbegin < SERVO_FRAME-2*SERVO_PULSE_MAX
+			|| servo_rcdeferred)
+	{
+		servo_doRCread_end();
 		servo_doRCread_start();
-		#endif
 	}
-	else	// regular start of a new pulse
+	else servo_rcdeferred=1;
+	#endif
+
+	// publish the staged values, the schedule was built by the last servo_stage_commit()
+	// (a writer half way through has not built one yet, its values wait for the next frame)
+	if(servo_ready)
+	{
+		sched=servo_live;
+		servo_live=servo_next;
+		servo_next=sched;
+		servo_ready=0;
+	}
+	sched=servo_live;
+	if(sched->active==0) return;
+
+	// start all pulses, one write per port
+	for(i=0; i<sched->rise_ports; i++)
 	{
-		if(servo_value[current_servo] != SERVO_NO_PULSE) // regular pulse value
-		{
-			// start pulse
-			set_bit(*servo_port[current_servo], servo_pin[current_servo]);
-#ifdef _REVERSE_SERVOS_
-			// set inverse pulse length, and wait for overflow
-			// servo values are stored as twice their us value
-			TCNT1= servo_value[current_servo]-4*SERVO_PULSE_CENTER;
-#else
-			// set normal pulse length, and wait for overflow
-			TCNT1= -(servo_value[current_servo]);
-#endif
+		*sched->rise_port[i] |= sched->rise_mask[i];
+	}
+	servo_frame_start=TCNT1;
 
-		}
-		else	// SERVO_NO_PULSE means no output, wait minimum pulse value
+	// and wait for the first one to end
+	current_servo=0;
+	OCR1B=servo_frame_start+sched->end[0];
+	set_bit(TIFR, OCF1B);	// clear the match from last frame (by setting the flag to 1)
+	set_bit(TIMSK, OCIE1B);
+}
+
+/******************************************************
+ * Counter1 Compare B interrupt, end of a servo pulse
+ * Ends the pulse due now and arms Compare B for the next one.
+ * Pulses ending within SERVO_EDGE_MARGIN ticks are waited for
+ * and ended here, an interrupt could come too late for them.
+ ***************************************************/
+ISR(TIMER1_COMPB_vect)
+{
+	uint16_t end;
+	servo_schedule_t* sched=servo_live;
+	uint8_t s;
+
+	for(;;)
+	{
+		s=sched->order[current_servo];
+		*servo_port[s] &= ~servo_mask[s];
+		current_servo++;
+		if(current_servo>=sched->active) // all pulses done, nothing more until next frame
 		{
-			TCNT1= -SERVO_PULSE_MIN;
+			clear_bit(TIMSK, OCIE1B);
+			return;
 		}
+		end=servo_frame_start+sched->end[current_servo];
+		if(end > TCNT1+SERVO_EDGE_MARGIN) break;
+		while(TCNT1 < end);	// close to the previous one, end it from here
 	}
+	OCR1B=end;
 }
 
 /***********************************
@@ -367,30 +560,35 @@ void servo_doRCread_init()
 	servo_rcend=0;
 	servo_gotpulse=0;
 	servo_rctimeout=0;
+	servo_rcdeferred=0;
 	servo_rcpulse=SERVO_NO_PULSE;
 }
 
-// this is called by the servo interrupt routine on beginning long pause cycle
+// this is called by the servo interrupt routine at the frame start
 void servo_doRCread_start()
 {
 	set_bit(TCCR1B, ICES1); 	// trigger on rising edge
 	set_bit(TIFR, ICF1);		// always clear interrupt flag (by setting it to 1) after changing the edge
 								// TIFR is defined to TIFR1 for the Atmega168
 	servo_gotpulse=0;			// got no pulse yet in this cycle
+	servo_rcdeferred=0;
 	set_bit(TIMSK, ICIE1);		// enable input capture interrupts - rest of the work is done by interrupt handler
 }
 
-// this is called by the servo interrupt routine on resuming after long pause cycle
+// this is called by the servo interrupt routine at the frame start, before restarting the capture
 void servo_doRCread_end()
 {
 	//uart0_puts("in RC end \n\r");
-	clear_bit(TIMSK, ICIE1);	// disable further ICP interrupts, no more readings until long pause
+	clear_bit(TIMSK, ICIE1);	// disable further ICP interrupts until the capture is restarted
 
 	// we got a valid pulse reading, store intermediate result.
 	if(servo_gotpulse)
 	{
+		uint16_t width=servo_rcend-servo_rcbegin;
+		if(servo_rcend < servo_rcbegin) width+=SERVO_FRAME;	// counter wrapped at the frame start
+
 		servo_rctimeout=0;						// reset timeout count
-		servo_rctemp=servo_rcend-servo_rcbegin;	//hold the intermediate result without further processing
+		servo_rctemp=width;						//hold the intermediate result without further processing
 		servo_rcvalid=1;						// flag that there is a valid result in the temporary variable
 	}
 	// else update the timeout count
@@ -0,0 +1,59 @@
+/*
+ * servo_out.c
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *      Servo output interface used by the sequencer, see servo_out.h
+ *      Dispatches on the servo number to servo.c or pca9685.c
+ */
+
+#include "servo_out.h"
+
+void servo_out_init()
+{
+#ifdef SERVO_PCA9685
+	pca9685_init();
+#endif
+}
+
+void servo_out_set(uint8_t servo, int16_t value)
+{
+	if(servo<=SERVO_NUM) servo_set(servo, value);
+#ifdef SERVO_PCA9685
+	else pca9685_set(servo-SERVO_NUM, value);
+#endif
+}
+
+int16_t servo_out_read(uint8_t servo)
+{
+	if(servo<=SERVO_NUM) return servo_read(servo);
+#ifdef SERVO_PCA9685
+	return pca9685_read(servo-SERVO_NUM);
+#else
+	return 0;
+#endif
+}
+
+void servo_out_stage_begin()
+{
+	servo_stage_begin();
+#ifdef SERVO_PCA9685
+	pca9685_stage_begin();
+#endif
+}
+
+void servo_out_stage_commit()
+{
+	servo_stage_commit();
+#ifdef SERVO_PCA9685
+	pca9685_stage_commit();
+#endif
+}
+
+// call from the main loop
+void servo_out_task()
+{
+#ifdef SERVO_PCA9685
+	pca9685_task();
+#endif
+}
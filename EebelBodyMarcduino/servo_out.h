@@ -0,0 +1,41 @@
+/*
+ * servo_out.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *      Servo output interface used by the sequencer
+ *      Servos 1 to SERVO_NUM are the TIMER1 outputs of servo.c,
+ *      the next PCA9685_SERVO_NUM are PCA9685 channels on I2C (if SERVO_PCA9685 is defined in pca9685.h)
+ *
+ *      Usage:
+ *      servo_out_init();	// after servo_init() and i2c_init()
+ *      servo_out_set( servo number (between 1 and SERVO_OUT_NUM), value between 500 and 2500);
+ *      position = servo_out_read(servo number);
+ *      servo_out_stage_begin(); ... servo_out_stage_commit();	// moves that must start together
+ *      servo_out_task();	// call from the main loop, sends the I2C outputs
+ *
+ *      With SERVO_PCA9685, the sequences and speed arrays in panel_sequences.h
+ *      need a column for each of the SERVO_OUT_NUM servos.
+ */
+
+#ifndef SERVO_OUT_H_
+#define SERVO_OUT_H_
+
+#include <stdint.h>
+#include "servo.h"
+#include "pca9685.h"
+
+#ifdef SERVO_PCA9685
+#define SERVO_OUT_NUM	(SERVO_NUM+PCA9685_SERVO_NUM)
+#else
+#define SERVO_OUT_NUM	SERVO_NUM
+#endif
+
+void servo_out_init();
+void servo_out_set(uint8_t servo, int16_t value);
+int16_t servo_out_read(uint8_t servo);
+void servo_out_stage_begin();
+void servo_out_stage_commit();
+void servo_out_task();
+
+#endif /* SERVO_OUT_H_ */
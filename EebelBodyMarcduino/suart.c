@@ -1,13 +1,13 @@
 /*
  * softuart.c
  * Software serial communication implementation
- * Does not use timers, just delays
- * For best timing compile with interrupts off (define SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT),
- * but at 9600 bauds with short interrupts it is not necessary
+ * Sends the bits from the timer2 compare interrupts, see suart.h
  * v1.0 - clean C code, inspired from complex arduino C++ library
  * v1.1 - correct assembly routine so it compiles in gcc 4.4
  * v1.2 - add support for 2 suart pins
  * v1.3 - switch for MarcDuino v1 and v2 Suart2 pin in header
+ * v1.4 - interrupt driven transmit with output buffers, replaces the delay loops
+ * v1.5 - receive with a pin change interrupt and input buffers, shares the compare interrupt with transmit
  *
 */
 
@@ -19,191 +19,341 @@
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 #include "toolbox.h"
+#include "fifo.h"
 #include "suart.h"
 
-// Delay lookup table
-
-typedef struct _DELAY_TABLE
-{
-  long baud;
-  unsigned short rx_delay_centering;
-  unsigned short rx_delay_intrabit;
-  unsigned short rx_delay_stopbit;
-  unsigned short tx_delay;
-} DELAY_TABLE;
-
-// delay tables are available for 8 MHz, 16 MHz and 20 MHz clocks only
-// stored in program memory to save RAM
-
-#if F_CPU == 16000000
-
-static const DELAY_TABLE PROGMEM suart_delay_table[] =
-{
-  //  baud    rxcenter   rxintra    rxstop    tx
-  { 115200,   1,         17,        17,       12,    },
-  { 57600,    10,        37,        37,       33,    },
-  { 38400,    25,        57,        57,       54,    },
-  { 31250,    31,        70,        70,       68,    },
-  { 28800,    34,        77,        77,       74,    },
-  { 19200,    54,        117,       117,      114,   },
-  { 14400,    74,        156,       156,      153,   },
-  { 9600,     114,       236,       236,      233,   },
-  { 4800,     233,       474,       474,      471,   },
-  { 2400,     471,       950,       950,      947,   },
-  { 1200,     947,       1902,      1902,     1899,  },
-  { 300,      3804,      7617,      7617,     7614,  },
-};
-
-const int XMIT_START_ADJUSTMENT = 5;
-
-#elif F_CPU == 8000000
-
-static const DELAY_TABLE suart_delay_table[] PROGMEM =
-{
-  //  baud    rxcenter    rxintra    rxstop  tx
-  { 115200,   1,          5,         5,      3,      },
-  { 57600,    1,          15,        15,     13,     },
-  { 38400,    2,          25,        26,     23,     },
-  { 31250,    7,          32,        33,     29,     },
-  { 28800,    11,         35,        35,     32,     },
-  { 19200,    20,         55,        55,     52,     },
-  { 14400,    30,         75,        75,     72,     },
-  { 9600,     50,         114,       114,    112,    },
-  { 4800,     110,        233,       233,    230,    },
-  { 2400,     229,        472,       472,    469,    },
-  { 1200,     467,        948,       948,    945,    },
-  { 300,      1895,       3805,      3805,   3802,   },
-};
-
-const int XMIT_START_ADJUSTMENT = 4;
-
-#elif F_CPU == 20000000
-
-// 20MHz support courtesy of the good people at macegr.com.
-// Thanks, Garrett!
-
-static const DELAY_TABLE PROGMEM suart_delay_table[] =
-{
-  //  baud    rxcenter    rxintra    rxstop  tx
-  { 115200,   3,          21,        21,     18,     },
-  { 57600,    20,         43,        43,     41,     },
-  { 38400,    37,         73,        73,     70,     },
-  { 31250,    45,         89,        89,     88,     },
-  { 28800,    46,         98,        98,     95,     },
-  { 19200,    71,         148,       148,    145,    },
-  { 14400,    96,         197,       197,    194,    },
-  { 9600,     146,        297,       297,    294,    },
-  { 4800,     296,        595,       595,    592,    },
-  { 2400,     592,        1189,      1189,   1186,   },
-  { 1200,     1187,       2379,      2379,   2376,   },
-  { 300,      4759,       9523,      9523,   9520,   },
-};
-
-const int XMIT_START_ADJUSTMENT = 6;
+#ifndef TIMSK2
+#error suart needs the timer2 compare A and B interrupts of the ATmega168/328
+#endif
 
-#else
+#if !FIFO_SIZE_OK(SUART_TX_BUFFER_SIZE) || !FIFO_SIZE_OK(SUART_RX_BUFFER_SIZE) \
+	|| !FIFO_SIZE_OK(SUART2_TX_BUFFER_SIZE) || !FIFO_SIZE_OK(SUART2_RX_BUFFER_SIZE)
+#error suart buffer sizes must be powers of two
+#endif
 
-#error This version of SoftUart supports only 20, 16 and 8MHz processors
+// timer2 runs at F_CPU/32, a bit lasts between SUART_STEP_MIN and 255 counts
+#define SUART_PRESCALER	32
+#define SUART_STEP_MIN	8
+#define SUART_LATENCY	4		// counts before the start bit of a byte sent while idle
+#define SUART_MARGIN	3		// counts, a bit that close is done now rather than scheduled
 
-#endif
+// transmit state of a port
+typedef struct
+{
+	fifo_t fifo;			// bytes waiting to be sent
+	uint8_t data;			// byte being sent, shifted out
+	uint8_t bit;			// 0 idle, 1 start bit sent, 2 to 9 data bits sent, 10 stop bit sent
+	uint8_t next;			// timer2 count of the next bit
+} suart_tx_t;
+
+// receive state of a port
+typedef struct
+{
+	fifo_t fifo;			// bytes received, waiting to be read
+	uint8_t data;			// byte being received, shifted in
+	uint8_t bit;			// 0 listening, 1 start bit edge seen, 2 to 9 data bits, 10 stop bit
+	uint8_t next;			// timer2 count of the next sample
+} suart_rx_t;
+
+typedef struct
+{
+	uint8_t step;			// timer2 counts per bit, 0 if the port is not initialized
+	suart_tx_t tx;
+	suart_rx_t rx;
+} suart_port_t;
+
+#define SUART_TX_DONE	2	// suart_tx_next() return when there is nothing left to send
+
+// suart_event() results, the pin work left to the interrupt of the port
+#define SUART_EV_TX		0x01	// write the Tx pin
+#define SUART_EV_HIGH	0x02	// level to write
+#define SUART_EV_LISTEN	0x04	// byte received, listen for the next start bit
+#define SUART_EV_IDLE	0x08	// nothing more to send or receive, disable the compare interrupt
+
+// timer2 counts per bit, 0 if the baud rate can't be done
+static uint8_t suart_step(long speed)
+{
+	long step;
+	if(speed<=0) return 0;
+	step=(F_CPU/SUART_PRESCALER+speed/2)/speed;
+	if(step<SUART_STEP_MIN || step>255) return 0;
+	return (uint8_t)step;
+}
+
+// timer2 free running, each port schedules its next bit with its own compare register
+static void suart_timer_init()
+{
+	TCCR2A=0;						// normal mode
+	TCCR2B=_BV(CS21) | _BV(CS20);	// prescaler 32
+}
+
+// queue a byte, wait for room if the buffer is full
+static void suart_tx_put(suart_tx_t *p, uint8_t b)
+{
+	uint8_t sreg;
+	for(;;)
+	{
+		// the completion callbacks of the sequencer send from the realtime interrupt too,
+		// two producers have to take turns
+		sreg=SREG;
+		cli();
+		if(_inline_fifo_put(&p->fifo, b))
+		{
+			SREG=sreg;
+			return;
+		}
+		SREG=sreg;
+		// with interrupts off the buffer would never empty, drop the byte
+		if(!(sreg & _BV(SREG_I))) return;
+	}
+}
+
+// level of the next bit, or SUART_TX_DONE. Called at interrupt time.
+static inline uint8_t suart_tx_next(suart_tx_t *p)
+{
+	uint8_t level;
+
+	// idle, or stop bit done: start the next byte
+	if(p->bit==0 || p->bit==10)
+	{
+		if(!fifo_count(&p->fifo))
+		{
+			p->bit=0;
+			return SUART_TX_DONE;
+		}
+		p->data=_inline_fifo_get(&p->fifo);
+		p->bit=1;
+		return LOW;			// start bit
+	}
+
+	if(p->bit==9)
+	{
+		p->bit=10;
+		return HIGH;		// stop bit
+	}
+
+	level= (p->data & 0x01) ? HIGH : LOW;
+	p->data>>=1;
+	p->bit++;
+	return level;
+}
+
+// takes the sample in the middle of a bit, returns 1 when done with the byte.
+// Called at interrupt time.
+static inline uint8_t suart_rx_next(suart_rx_t *p, uint8_t level)
+{
+	// middle of the start bit, the line back high was a glitch
+	if(p->bit==1)
+	{
+		if(level)
+		{
+			p->bit=0;
+			return 1;
+		}
+		p->data=0;
+		p->bit=2;
+		return 0;
+	}
+
+	if(p->bit<10)
+	{
+		p->data>>=1;
+		if(level) p->data|=0x80;
+		p->bit++;
+		return 0;
+	}
+
+	// stop bit, the byte is dropped if it is low (framing error) or if the buffer is full
+	if(level) _inline_fifo_put(&p->fifo, p->data);
+	p->bit=0;
+	return 1;
+}
+
+// Transmit and receive run on their own bit clocks, and are never scheduled more than one bit
+// ahead. So a count that is further than one bit away is in fact late.
+static inline uint8_t suart_due(suart_port_t *p, uint8_t next, uint8_t now)
+{
+	uint8_t ahead=next-now;
+	return ahead<=SUART_MARGIN || ahead>p->step;
+}
+
+// does the bits of a port that are due, and sets the compare register for the next one.
+// Called from the compare interrupt of the port, with the level of its Rx pin.
+static inline uint8_t suart_event(suart_port_t *p, uint8_t rxlevel, volatile uint8_t *ocr)
+{
+	uint8_t now=TCNT2;
+	uint8_t ev=0;
+	uint8_t level;
+
+	if(p->tx.bit && suart_due(p, p->tx.next, now))
+	{
+		p->tx.next+=p->step;
+		level=suart_tx_next(&p->tx);
+		if(level!=SUART_TX_DONE) ev= level ? SUART_EV_TX | SUART_EV_HIGH : SUART_EV_TX;
+	}
+
+	if(p->rx.bit && suart_due(p, p->rx.next, now))
+	{
+		p->rx.next+=p->step;
+		if(suart_rx_next(&p->rx, rxlevel)) ev|=SUART_EV_LISTEN;
+	}
+
+	// whichever comes first
+	if(p->tx.bit && p->rx.bit)
+		*ocr= (uint8_t)(p->rx.next-now) < (uint8_t)(p->tx.next-now) ? p->rx.next : p->tx.next;
+	else if(p->tx.bit) *ocr=p->tx.next;
+	else if(p->rx.bit) *ocr=p->rx.next;
+	else ev|=SUART_EV_IDLE;
+
+	return ev;
+}
+
+// makes sure the compare interrupt of a port comes in time for a new bit at count next.
+// Called with interrupts off.
+static inline void suart_schedule(suart_port_t *p, uint8_t next, uint8_t now,
+		volatile uint8_t *ocr, uint8_t ocie, uint8_t ocf)
+{
+	uint8_t ahead;
 
+	if(bit_is_clear(TIMSK2, ocie))
+	{
+		*ocr=next;
+		TIFR2=_BV(ocf);			// clear a stale compare flag
+		set_bit(TIMSK2, ocie);
+		return;
+	}
+
+	// the interrupt reschedules both clocks when it runs, nothing to do if it is about to
+	ahead=*ocr-now;
+	if(ahead<=SUART_MARGIN || ahead>p->step) return;
+	if((uint8_t)(next-now)<ahead) *ocr=next;
+}
+
+// wakes up sending on an idle port, called with interrupts off
+static inline void suart_tx_start(suart_port_t *p, volatile uint8_t *ocr, uint8_t ocie, uint8_t ocf)
+{
+	uint8_t now;
+
+	if(p->tx.bit) return;
+	now=TCNT2;
+	p->tx.bit=10;			// as if the stop bit of a previous byte was just sent
+	p->tx.next=now+SUART_LATENCY;
+	suart_schedule(p, p->tx.next, now, ocr, ocie, ocf);
+}
 
-// variables used by this module [NEED TO RENAME]
-
-static uint16_t _rx_delay_centering;
-static uint16_t _rx_delay_intrabit;
-static uint16_t _rx_delay_stopbit;
-static uint16_t _tx_delay;
-
-// tuned delay loop
-inline void suart_tunedDelay(uint16_t delay) {
-  uint8_t tmp=0;
-
-  asm volatile("sbiw    %0, 0x01 \n\t"
-    "ldi %1, 0xFF \n\t"
-    "cpi %A0, 0xFF \n\t"
-    "cpc %B0, %1 \n\t"
-    "brne .-10 \n\t"
-//    : "+r" (delay), "+a" (tmp)
-//	for gcc 4.4 compiler, need to use 'w' qualifier to force it to use upper registers for sbiw
-//	instruction. Any register 'r' will not work with sbiw causing asm error.
-    : "+w" (delay), "+a" (tmp)
-    : "0" (delay)
-    );
+// start bit edge seen, first sample in its middle. Called from the pin change interrupt.
+static inline void suart_rx_start(suart_port_t *p, uint8_t now, volatile uint8_t *ocr, uint8_t ocie, uint8_t ocf)
+{
+	p->rx.bit=1;
+	p->rx.next=now+p->step/2;
+	suart_schedule(p, p->rx.next, now, ocr, ocie, ocf);
 }
 
+
+static uint8_t suart_buffer[SUART_TX_BUFFER_SIZE];
+static suart_port_t suart;
+#ifdef SUART_RX_PIN
+static uint8_t suart_rx_buffer[SUART_RX_BUFFER_SIZE];
+#endif
+
 inline void suart_tx_pin_write(uint8_t pin_state)
 {
     digitalWrite(SUART_TX_PORT, SUART_TX_PIN, pin_state);
 }
 
+inline uint8_t suart_rx_pin_read()
+{
+#ifdef SUART_RX_PIN
+	return digitalRead(SUART_RX_PORT, SUART_RX_PIN);
+#else
+	return HIGH;
+#endif
+}
+
 // Module Init
 void suart_init(long speed)
 {
-  _rx_delay_centering=0;
-  _rx_delay_intrabit=0;
-  _rx_delay_stopbit=0;
-  _tx_delay=0;
+  // stop sending and receiving before changing the settings
+  clear_bit(TIMSK2, OCIE2A);
+#ifdef SUART_RX_PIN
+  clear_bit(SUART_RX_PCMSK, SUART_RX_PIN);
+#endif
+  suart.tx.bit=0;
+  suart.rx.bit=0;
+  fifo_init(&suart.tx.fifo, suart_buffer, SUART_TX_BUFFER_SIZE);
 
   // set Tx pin for output
   digitalMode(SUART_TX_PORT, SUART_TX_PIN, OUTPUT);
   digitalWrite(SUART_TX_PORT, SUART_TX_PIN, HIGH);
 
-  // read delay settings from table to match baud rate
+  // bit time in timer2 counts
+  suart.step=suart_step(speed);
+  suart_timer_init();
 
-  uint8_t i;
-  for (i=0; i<sizeof(suart_delay_table)/sizeof(suart_delay_table[0]); ++i)
+#ifdef SUART_RX_PIN
+  // set Rx pin for input, the pull-up keeps an unconnected line idle
+  fifo_init(&suart.rx.fifo, suart_rx_buffer, SUART_RX_BUFFER_SIZE);
+  digitalMode(SUART_RX_PORT, SUART_RX_PIN, INPUT);
+  digitalWrite(SUART_RX_PORT, SUART_RX_PIN, HIGH);
+  if(suart.step)
   {
-    long baud = pgm_read_dword(&suart_delay_table[i].baud);
-    if (baud == speed)
-    {
-      _rx_delay_centering = pgm_read_word(&suart_delay_table[i].rx_delay_centering);
-      _rx_delay_intrabit = pgm_read_word(&suart_delay_table[i].rx_delay_intrabit);
-      _rx_delay_stopbit = pgm_read_word(&suart_delay_table[i].rx_delay_stopbit);
-      _tx_delay = pgm_read_word(&suart_delay_table[i].tx_delay);
-      break;
-    }
+	  set_bit(SUART_RX_PCMSK, SUART_RX_PIN);
+	  set_bit(PCICR, SUART_RX_PCIE);
   }
+#endif
 }
 
-
 void suart_putc(uint8_t b)
 {
-	uint8_t mask;
+  uint8_t sreg;
 
-  if (_tx_delay == 0)
+  if (suart.step == 0)
     return;
 
-#ifdef SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT
-  uint8_t oldSREG = SREG;
-  cli();  // turn off interrupts for a clean txmit
-#endif
-
-  // Write the start bit
-  suart_tx_pin_write(LOW);
-  suart_tunedDelay(_tx_delay + XMIT_START_ADJUSTMENT);
+  suart_tx_put(&suart.tx, b);
 
-  // Write each of the 8 bits
+  // wake up the transmit if it was idle
+  sreg=SREG;
+  cli();
+  suart_tx_start(&suart, &OCR2A, OCIE2A, OCF2A);
+  SREG=sreg;
+}
 
-	for (mask = 0x01; mask; mask <<= 1)
-	{
-	  if (b & mask) // choose bit
-		suart_tx_pin_write(HIGH); // send 1
-	  else
-		suart_tx_pin_write(LOW); // send 0
+int suart_getc(void)
+{
+	return fifo_get_nowait(&suart.rx.fifo);
+}
 
-	  suart_tunedDelay(_tx_delay);
-	}
+uint8_t suart_available(void)
+{
+	return fifo_count(&suart.rx.fifo);
+}
 
-	suart_tx_pin_write(HIGH); // restore pin to natural state
+// sends and receives the bits of suart, each interrupt sets the compare for the next one
+ISR(TIMER2_COMPA_vect)
+{
+	uint8_t ev;
 
-#ifdef SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT
-  SREG = oldSREG; // turn interrupts back on
-  sei();
+	ev=suart_event(&suart, suart_rx_pin_read(), &OCR2A);
+	if(ev & SUART_EV_TX) suart_tx_pin_write(ev & SUART_EV_HIGH ? HIGH : LOW);
+#ifdef SUART_RX_PIN
+	if(ev & SUART_EV_LISTEN) set_bit(SUART_RX_PCMSK, SUART_RX_PIN);
 #endif
+	if(ev & SUART_EV_IDLE) clear_bit(TIMSK2, OCIE2A);
+}
 
-  suart_tunedDelay(_tx_delay);
+#ifdef SUART_RX_PIN
+// start bit of a byte received on suart. The pin change interrupt stays off until its stop bit.
+ISR(SUART_RX_vect)
+{
+	uint8_t now=TCNT2;
+
+	// only a falling edge while listening, or the pin is not ours
+	if(suart.rx.bit || suart_rx_pin_read()==HIGH) return;
+	clear_bit(SUART_RX_PCMSK, SUART_RX_PIN);
+	suart_rx_start(&suart, now, &OCR2A, OCIE2A, OCF2A);
 }
+#endif
 
 void suart_puts(char* string)
 {
@@ -233,43 +383,57 @@ void suart_puts_p(const char *progmem_s )
 // **** suart2 functions for dual port ********
 #ifdef SUART_DUAL_PORT
 
-static uint16_t _rx2_delay_centering;
-static uint16_t _rx2_delay_intrabit;
-static uint16_t _rx2_delay_stopbit;
-static uint16_t _tx2_delay;
+static uint8_t suart2_buffer[SUART2_TX_BUFFER_SIZE];
+static suart_port_t suart2;
+#ifdef SUART2_RX_PIN
+static uint8_t suart2_rx_buffer[SUART2_RX_BUFFER_SIZE];
+#endif
 
 inline void suart2_tx_pin_write(uint8_t pin_state)
 {
     digitalWrite(SUART2_TX_PORT, SUART2_TX_PIN, pin_state);
 }
 
+inline uint8_t suart2_rx_pin_read()
+{
+#ifdef SUART2_RX_PIN
+	return digitalRead(SUART2_RX_PORT, SUART2_RX_PIN);
+#else
+	return HIGH;
+#endif
+}
+
 // Module Init
 void suart2_init(long speed)
 {
-  _rx2_delay_centering=0;
-  _rx2_delay_intrabit=0;
-  _rx2_delay_stopbit=0;
-  _tx2_delay=0;
+  // stop sending and receiving before changing the settings
+  clear_bit(TIMSK2, OCIE2B);
+#ifdef SUART2_RX_PIN
+  clear_bit(SUART2_RX_PCMSK, SUART2_RX_PIN);
+#endif
+  suart2.tx.bit=0;
+  suart2.rx.bit=0;
+  fifo_init(&suart2.tx.fifo, suart2_buffer, SUART2_TX_BUFFER_SIZE);
 
   // set Tx pin for output
   digitalMode(SUART2_TX_PORT, SUART2_TX_PIN, OUTPUT);
   digitalWrite(SUART2_TX_PORT, SUART2_TX_PIN, HIGH);
 
-  // read delay settings from table to match baud rate
+  // bit time in timer2 counts
+  suart2.step=suart_step(speed);
+  suart_timer_init();
 
-  uint8_t i;
-  for (i=0; i<sizeof(suart_delay_table)/sizeof(suart_delay_table[0]); ++i)
+#ifdef SUART2_RX_PIN
+  // set Rx pin for input, the pull-up keeps an unconnected line idle
+  fifo_init(&suart2.rx.fifo, suart2_rx_buffer, SUART2_RX_BUFFER_SIZE);
+  digitalMode(SUART2_RX_PORT, SUART2_RX_PIN, INPUT);
+  digitalWrite(SUART2_RX_PORT, SUART2_RX_PIN, HIGH);
+  if(suart2.step)
   {
-    long baud = pgm_read_dword(&suart_delay_table[i].baud);
-    if (baud == speed)
-    {
-      _rx2_delay_centering = pgm_read_word(&suart_delay_table[i].rx_delay_centering);
-      _rx2_delay_intrabit = pgm_read_word(&suart_delay_table[i].rx_delay_intrabit);
-      _rx2_delay_stopbit = pgm_read_word(&suart_delay_table[i].rx_delay_stopbit);
-      _tx2_delay = pgm_read_word(&suart_delay_table[i].tx_delay);
-      break;
-    }
+	  set_bit(SUART2_RX_PCMSK, SUART2_RX_PIN);
+	  set_bit(PCICR, SUART2_RX_PCIE);
   }
+#endif
 
   /**** debug
   suart2_puts("\r\nsuart2 output test\r\n");
@@ -282,41 +446,55 @@ void suart2_init(long speed)
 
 void suart2_putc(uint8_t b)
 {
-	uint8_t mask;
+  uint8_t sreg;
 
-  if (_tx2_delay == 0)
+  if (suart2.step == 0)
     return;
 
-#ifdef SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT
-  uint8_t oldSREG = SREG;
-  cli();  // turn off interrupts for a clean txmit
-#endif
-
-  // Write the start bit
-  suart2_tx_pin_write(LOW);
-  suart_tunedDelay(_tx2_delay + XMIT_START_ADJUSTMENT);
+  suart_tx_put(&suart2.tx, b);
 
-  // Write each of the 8 bits
+  // wake up the transmit if it was idle
+  sreg=SREG;
+  cli();
+  suart_tx_start(&suart2, &OCR2B, OCIE2B, OCF2B);
+  SREG=sreg;
+}
 
-	for (mask = 0x01; mask; mask <<= 1)
-	{
-	  if (b & mask) // choose bit
-		suart2_tx_pin_write(HIGH); // send 1
-	  else
-		suart2_tx_pin_write(LOW); // send 0
+int suart2_getc(void)
+{
+	return fifo_get_nowait(&suart2.rx.fifo);
+}
 
-	  suart_tunedDelay(_tx2_delay);
-	}
+uint8_t suart2_available(void)
+{
+	return fifo_count(&suart2.rx.fifo);
+}
 
-	suart2_tx_pin_write(HIGH); // restore pin to natural state
+// sends and receives the bits of suart2
+ISR(TIMER2_COMPB_vect)
+{
+	uint8_t ev;
 
-#ifdef SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT
-  SREG = oldSREG; // turn interrupts back on
-  sei();
+	ev=suart_event(&suart2, suart2_rx_pin_read(), &OCR2B);
+	if(ev & SUART_EV_TX) suart2_tx_pin_write(ev & SUART_EV_HIGH ? HIGH : LOW);
+#ifdef SUART2_RX_PIN
+	if(ev & SUART_EV_LISTEN) set_bit(SUART2_RX_PCMSK, SUART2_RX_PIN);
 #endif
+	if(ev & SUART_EV_IDLE) clear_bit(TIMSK2, OCIE2B);
+}
 
-  suart_tunedDelay(_tx2_delay);
+#ifdef SUART2_RX_PIN
+// start bit of a byte received on suart2. The pin change interrupt stays off until its stop bit.
+ISR(SUART2_RX_vect)
+{
+	uint8_t now=TCNT2;
+
+	// only a falling edge while listening, or the pin is not ours
+	if(suart2.rx.bit || suart2_rx_pin_read()==HIGH) return;
+	clear_bit(SUART2_RX_PCMSK, SUART2_RX_PIN);
+	suart_rx_start(&suart2, now, &OCR2B, OCIE2B, OCF2B);
 }
+#endif
 
 void suart2_puts(char* string)
 {
@@ -2,11 +2,19 @@
  * suart.c
  * Software serial communication implementation
  *
- * Turns a regular I/O pin into a serial output
+ * Turns a regular I/O pin into a serial output, and optionally another one into a serial input
  *
- * In order to preserve hardware timers for other uses, this uses calibrated delays
- * For best timing compile with interrupts off (define SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT),
- * but at 9600 bauds with short interrupts it does not matter
+ * The bits are sent by the timer2 compare interrupts (compare A for suart, B for suart2)
+ * from an output buffer, so suart_putc() returns right away unless the buffer is full,
+ * and interrupts are never held off for a whole byte.
+ * Timer2 runs at F_CPU/32, 2400 to 38400 bauds at 16 MHz.
+ *
+ * Receiving uses the same compare interrupt as sending on the port: a pin change interrupt
+ * catches the falling edge of the start bit, then the compare interrupt samples the middle of
+ * each bit and puts the byte in an input buffer read with suart_getc().
+ * Sending and receiving can overlap, the interrupt serves whichever bit comes first.
+ * Receiving is reliable up to 19200 bauds. Each Rx pin needs its own pin change group
+ * (port B, C or D), since each group has a single interrupt.
  *
  * Created July 7, 2012
  * Author: Marc Verdiell
@@ -30,12 +38,13 @@
 # define F_CPU 16000000UL
 #endif
 
+// output buffers, a forwarded command is sent while the main loop goes on
+#define SUART_TX_BUFFER_SIZE	32
+#define SUART2_TX_BUFFER_SIZE	16
 
-// for very high baud rates you might need to uncomment this for precise timing.
-// It will turn off interrupts while transmitting on the software UART.
-// But at 9600 bauds no need to do this if running interrupt handlers are fast enough
-
-#define SUART_TURN_OFF_INTERRUPTS_WHILE_TRANSMIT
+// input buffers, read by the main loop
+#define SUART_RX_BUFFER_SIZE	16
+#define SUART2_RX_BUFFER_SIZE	16
 
 
 // comment the following line out if you only need one SUART port
@@ -47,12 +56,25 @@
 #define SUART_TX_PIN	0
 #define SUART_TX_PORT 	PORTC
 
+// Rx pin, comment out to send only. PD7 is free on the MarcDuino boards.
+// The pin change mask, enable bit and vector must be the ones of the pin's port.
+#define SUART_RX_PIN	7
+#define SUART_RX_PORT	PORTD
+#define SUART_RX_PCMSK	PCMSK2
+#define SUART_RX_PCIE	PCIE2
+#define SUART_RX_vect	PCINT2_vect
+
 // just three functions needed for writing
+// suart_putc() waits only when the output buffer is full
 void suart_init(long baudrate);
 void suart_putc(uint8_t b);
 void suart_puts(char* string);
 void suart_puts_p(const char *progmem_s );
 
+// reading, never waits. suart_getc() returns -1 if nothing was received.
+int suart_getc(void);
+uint8_t suart_available(void);
+
 //*********second optional port ******
 #ifdef SUART_DUAL_PORT
 
@@ -64,6 +86,13 @@ void suart_puts_p(const char *progmem_s );
 		#define SUART2_TX_PORT	PORTC
 	#endif
 
+	// Rx pin, off by default. PC2/AUX1 can be used when it doesn't drive the WiFly reset.
+	//#define SUART2_RX_PIN		2
+	//#define SUART2_RX_PORT	PORTC
+	//#define SUART2_RX_PCMSK	PCMSK1
+	//#define SUART2_RX_PCIE	PCIE1
+	//#define SUART2_RX_vect	PCINT1_vect
+
 #endif
 
 void suart2_init(long baudrate);
@@ -71,4 +100,7 @@ void suart2_putc(uint8_t b);
 void suart2_puts(char* string);
 void suart2_puts_p(const char *progmem_s );
 
+int suart2_getc(void);
+uint8_t suart2_available(void);
+
 #endif
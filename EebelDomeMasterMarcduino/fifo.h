@@ -3,13 +3,20 @@
  * In order to use, initialize like this:
  *
  * 	#include "fifo.h"
- * 	#define BUF_SIZE 10
+ * 	#define BUF_SIZE 16		// a power of two, up to 256
  * 	uint8_t buffer[BUF_SIZE];
  * 	fifo_t fifo;
  * 	...
  * 	    fifo_init (&fifo, buffer, BUF_SIZE);
  * 	...
  *
+ * 	Holds one byte less than the buffer size.
+ *
+ * 	Single producer, single consumer: one side only puts and the other only gets,
+ * 	typically an interrupt and the main loop. Each side only writes its own index,
+ * 	and the indexes are single bytes, so neither side needs to turn interrupts off.
+ * 	Several producers (or consumers) must take turns with cli() themselves.
+ *
  * 	***************************************/
 
 #ifndef FIFO_H
@@ -18,88 +25,73 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
-// metadata structure, includes everything but the buffer, which is implied with the pointers
+// true if a buffer size can be used, for compile time checks
+#define FIFO_SIZE_OK(size) ((size)>=2 && (size)<=256 && ((size) & ((size)-1))==0)
+
+// metadata structure, includes everything but the buffer
 typedef struct
 {
-	uint8_t volatile count;       // # of stored bytes
-	uint8_t size;                 // max buffer size
-	uint8_t *pread;               // read pointer
-	uint8_t *pwrite;              // write pointer
-	uint8_t read2end, write2end;  // # of bytes until overrun of read or write
+	uint8_t volatile head;	// write index, only changed by the producer
+	uint8_t volatile tail;	// read index, only changed by the consumer
+	uint8_t mask;			// buffer size - 1
+	uint8_t *buf;
 } fifo_t;
 
 // public interface
-void fifo_init (fifo_t*, uint8_t* buf, const uint8_t size);
+void fifo_init (fifo_t*, uint8_t* buf, const uint16_t size);
 uint8_t fifo_put (fifo_t*, const uint8_t data);
 uint8_t fifo_get_wait (fifo_t*);
 int fifo_get_nowait (fifo_t*);	// this one is annoying, returns -1 if no data
 int fifo_available(fifo_t *f);	// I made this one up instead
+uint8_t fifo_write (fifo_t*, const uint8_t *data, uint8_t n);	// bulk put, returns the number of bytes stored
+uint8_t fifo_read (fifo_t*, uint8_t *data, uint8_t n);		// bulk get, returns the number of bytes read
 
 // private interface, not accessible from outsite (static members)
 
+// keeps the compiler from moving buffer accesses across an index update
+#define fifo_barrier() __asm__ __volatile__ ("" ::: "memory")
+
+// number of stored bytes. Exact for either side, the other one can only make it better.
+static inline uint8_t
+fifo_count (fifo_t *f)
+{
+	return (f->head - f->tail) & f->mask;
+}
+
+// room left for the producer
+static inline uint8_t
+fifo_space (fifo_t *f)
+{
+	return f->mask - fifo_count(f);
+}
+
 // add a character to the buffer
 static inline uint8_t
 _inline_fifo_put (fifo_t *f, const uint8_t data)
 {
+	uint8_t head = f->head;
+	uint8_t next = (head + 1) & f->mask;
+
 	// return if no more space
-	if (f->count >= f->size)
+	if (next == f->tail)
 		return 0;
-	// get the write pointer
-	uint8_t * pwrite = f->pwrite;
-	// write the byte, THEN move pointer to the next position
-	*(pwrite++) = data;
-	// get the numbers of bytes left till end of buffer
-	uint8_t write2end = f->write2end;
-	// decrement numbers of bytes left, THEN test for none left
-	if (--write2end == 0)
-	{
-		// if end of linear buffer, rewind at beginning of buffer (this is implemented as a circular buffer)
-		write2end = f->size;	// size to end of linear buffer
-		pwrite -= write2end;	// rewind the write pointer to the beginning
-	}
-	
-	// store updated values of write pointers and write to end # of bytes
-	f->write2end = write2end;
-	f->pwrite = pwrite;
-
-	// block interrupts while we update count, so it does not change in interrupt context while we read it
-	uint8_t sreg = SREG;	// save status register
-	cli();					// no interrupts
-	f->count++;				// update count, we stored one more byte
-	SREG = sreg;			// reset status register
-							// ? no sei() code to re-enable interrupts. Or is the compiler putting one?
+	f->buf[head] = data;
+	// publish the byte only once it is in the buffer
+	fifo_barrier();
+	f->head = next;
 	return 1;
 }
 
-// read a character from the buffer
-static inline uint8_t 
+// read a character from the buffer, check that there is one first
+static inline uint8_t
 _inline_fifo_get (fifo_t *f)
 {
-	// get the read pointer
-	uint8_t *pread = f->pread;
-	// read the data, THEN advance the pointer
-	uint8_t data = *(pread++);
-	// get the size till end number
-	uint8_t read2end = f->read2end;
-	
-	// decrement size, THEN test no space left
-	if (--read2end == 0)
-	{
-		// if end of linear buffer, rewind to beginning (circular buffer)
-		read2end = f->size;	// full buffer available for read
-		pread -= read2end;	// move read pointer to beginning
-	}
-	
-	// update the read pointer and read2end values
-	f->pread = pread;
-	f->read2end = read2end;
-	
-	// update count, making sure that nobody elses accesses it in interrupt
-	uint8_t sreg = SREG;
-	cli();
-	f->count--;
-	SREG = sreg;
-	
+	uint8_t tail = f->tail;
+	uint8_t data = f->buf[tail];
+
+	// hand the slot back only once it is read
+	fifo_barrier();
+	f->tail = (tail + 1) & f->mask;
 	return data;
 }
 
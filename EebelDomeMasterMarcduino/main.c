@@ -112,6 +112,8 @@
  * :STxx buzz kill/soft hold: removes panel from RC control AND shuts servo off to eliminate buzz.
  * 		xx=00 all panels off RC servos off.
  * :HDxx RC hold: removes from RC, but does not turn servo off, keeps at last position. xx=00 all panels hold.
+ * :TExx sequence tempo, to keep the panel routines in time with the music. xx=50 normal speed,
+ * 		one percent per step, TE40 plays the sequences at 90%, TE60 at 110%. xx=00 back to normal.
  *
  *	Sequences details (see sequence_command, panel sequence matrices defined in panel_sequences.h)
  *	:SE00 Close all panels (full speed), servo off - use as init only. Use CL00 for all soft close.
@@ -159,9 +161,10 @@
 
 #include "toolbox.h"
 #include "servo.h"			// servo drivers
+#include "servo_out.h"		// servo outputs of the sequencer, including the I2C ones
 #include "realtime.h"		// real time interrupt services
 #include "serial.h"			// hardware serial
-#include "suart.h"			// software serial (write only)
+#include "suart.h"			// software serial
 #include "sequencer.h"		// servo sequencer
 #include "panel_sequences.h"	// panel sequences, moved off to another file for clarity
 
@@ -174,8 +177,12 @@
 #include "i2c.h"			// include I2C Master libraries for MarcDuino v2
 #endif
 
+// command lines are assembled by the serial receive interrupt
+#if !defined(SERIAL_LINE_INPUT) || SERIAL_LINE_LENGTH!=CMD_MAX_LENGTH || SERIAL_LINE_END!=CMD_END_CHAR
+#error serial.h line input must be on and match the command length and end character
+#endif
+
 // command globals
-char command_buffer[CMD_MAX_LENGTH];		// command string buffer
 uint8_t panel_rc_control[SERVO_NUM];		// flag array for which panels are under RC control
 uint8_t panel_to_silence[SERVO_NUM];		// flag array for servos we need to turn off after a panel is closed
 
@@ -189,6 +196,9 @@ rt_timer killbuzz_timer;
 //### experimental: timer to close TCP connection if no data received, for 3 seconds
 rt_timer TCP_timer;
 
+// serial_lines_dropped() count already reported
+uint8_t lines_dropped_reported=0;
+
 
 // string constants are in program memory to save DRAM
 const char strOK[] PROGMEM="OK\n\r";
@@ -197,18 +207,25 @@ const char strEnterPrompt[] PROGMEM="Enter panel command starting with \':\' \n\
 const char strSuart1OK[] PROGMEM="\n\rsuart1 Communication OK \n\r";
 const char strSuart2OK[] PROGMEM="\n\rsuart2 Communication OK \n\r";
 const char strStartCharErr[] PROGMEM="**Unrecognized Command Start Character\r\n";
+const char strLineDropErr[] PROGMEM="**Command Lines Dropped, Input Buffers Full\r\n";
 const char strInitializing[] PROGMEM="Initializing...\r\n";
 
-// utility to echo characters back cleanly
-void echo(char ch)
+// utility to echo a command line back cleanly
+// only what was kept of the line is echoed, a line longer than CMD_MAX_LENGTH-1 comes back cut
+void echo(char* line)
 {
-	// echo return and line feeds nicely on a terminal
-	if(ch=='\r' || ch=='\n' || ch == 0x0D )
+	// echo line feeds and the end of line nicely on a terminal
+	for(; *line; line++)
 	{
-		serial_putc('\n');
-		serial_putc('\r');
+		if(*line=='\n')
+		{
+			serial_putc('\n');
+			serial_putc('\r');
+		}
+		else serial_putc(*line);
 	}
-	else serial_putc(ch);
+	serial_putc('\n');
+	serial_putc('\r');
 }
 
 
@@ -236,11 +253,15 @@ int main(void) {
 	servo_init();
 	realtime_init();
 	seq_init();
+	seq_loadpositions(panel_positions, SEQ_SIZE(panel_positions));	// for the packed sequences
+	if(feedbackmessageon) report_packed_sequences();
 
 #ifdef _MARCDUINOV2_
 	// initialize I2C hardware on MarcDuino v2's with 10k pull-up resistors on.
 	i2c_init(TRUE);
 #endif
+	// sequencer servo outputs beyond SERVO_NUM, if any (see servo_out.h)
+	servo_out_init();
 
 	// register our buzz kill timer
 	rt_add_timer(&killbuzz_timer);
@@ -274,20 +295,26 @@ int main(void) {
 	/////////////////////////////////////////
 	// Serial Command Input
 	////////////////////////////////////////
-	char command_str[CMD_MAX_LENGTH];
-	bool command_available;
+	int8_t line;
+	char* command_str;
 
-	// check for command line input
-	if(serial_available())
+	// handle all the complete command lines, they are used in place in the serial line buffers
+	while((line=serial_line_get())>=0)
 	{
 		//### experimental, reset TCP timeout timer
 		TCP_timer=TCP_TIMER_VALUE;
 
-		char ch;
-		ch=serial_getc();										// get input
-		echo(ch);												// echo back
-		command_available=build_command(ch, command_str);		// build command line
-		if (command_available) dispatch_command(command_str);	// send command line to dispatcher
+		command_str=serial_line(line);
+		echo(command_str);							// echo back
+		dispatch_command(command_str);				// send command line to dispatcher
+		serial_line_release();						// buffer can take a new line
+	}
+
+	// report lines lost while all the line buffers were waiting (a long command was running)
+	if(serial_lines_dropped()!=lines_dropped_reported)
+	{
+		lines_dropped_reported=serial_lines_dropped();
+		if(errormessageon) serial_puts_p(strLineDropErr);
 	}
 
 	///////////////////////////////////////////
@@ -346,6 +373,7 @@ int main(void) {
 	////////////////////////////////////////
 	int16_t servovalue= servo_RCread();
 	uint8_t i;
+	servo_stage_begin();	// RC controlled panels move together
 	for(i=1; i<=SERVO_NUM; i++)
 	{
 		if(panel_rc_control[i-1]==1)
@@ -367,10 +395,12 @@ int main(void) {
 			}
 		}
 	}
+	servo_stage_commit();
 
 	// kill servo buzz if panel have been marked as just closed and the timeout period has expired
 	if(killbuzz_timer==0)
 	{
+		servo_stage_begin();
 		for(int i=1; i<=SERVO_NUM; i++)
 		{
 			if(panel_to_silence[i-1])
@@ -379,8 +409,14 @@ int main(void) {
 				panel_to_silence[i-1]=0;
 			}
 		}
+		servo_stage_commit();
 	}
 
+	/////////////////////////////////////////
+	// Servo outputs on I2C
+	////////////////////////////////////////
+	servo_out_task();
+
 	// simple debug RC input test: loopback input to servo
 	// servo_set(2, servo_RCread());
 
@@ -394,28 +430,6 @@ int main(void) {
 return 0;
 }
 
-// builds the command string from the character input
-uint8_t build_command(char ch, char* output_str)
-{
-	static uint8_t pos=0;
-
-	switch(ch)
-	{
-		case CMD_END_CHAR:								// end character recognized
-			command_buffer[pos]='\0';					// append the end of string character
-			pos=0;										// reset buffer pointer
-			strcpy(output_str, (char*)command_buffer);	// copy result
-			return TRUE;								// return and signal command ready
-			break;
-
-		default:										// regular character
-			command_buffer[pos]=ch;						// append the  character to the command string
-			if(pos<=CMD_MAX_LENGTH-1)pos++;				// too many characters, discard them.
-			break;
-	}
-	return FALSE;
-}
-
 // dispatches further command processing depending on start character
 void dispatch_command(char* command_str)
 {
@@ -752,6 +766,9 @@ void parse_panel_command(char* command_string, uint8_t length)
 	 * :HDxx as hold (hard hold)
 	 * 	Removes RC, hold the servo to last position
 	 * 	00=all panels that had RC will hold
+	 * :TExx as sequence tempo
+	 * 	50=normal, 01...99 = 51% to 149%
+	 * 	00=normal
 	 *
 	 */
 
@@ -828,6 +845,12 @@ void process_command(char* thecommand, char* theargument)
 		hold_command(value);
 		return;
 	};
+	if(strcmp(thecommand,CMD_TEMPO )==0)
+	{
+		serial_puts_p(strOK);
+		tempo_command(value);
+		return;
+	};
 
 	if(errormessageon) serial_puts_p(strPanelCmdErr);
 
@@ -885,7 +908,7 @@ void sequence_command(uint8_t value)
 			break;
 
 		case 2: // WAVE
-			seq_loadsequence(panel_wave, SEQ_SIZE(panel_wave));
+			seq_loadgenerator(&panel_wave);
 			seq_resetspeed();
 			HPFlash(4);							// flash holos for 4 seconds
 			SoundWave(); 						// happy sound
@@ -894,7 +917,7 @@ void sequence_command(uint8_t value)
 			break;
 
 		case 3: // MOODY FAST WAVE
-			seq_loadsequence(panel_fast_wave, SEQ_SIZE(panel_fast_wave));
+			seq_loadgenerator(&panel_fast_wave);
 			seq_resetspeed();
 			DisplayFlash4();  					// 4 seconds flash display
 			HPFlicker(4);						// HPs flicker for 4 seconds
@@ -904,7 +927,7 @@ void sequence_command(uint8_t value)
 			break;
 
 		case 4: // OPEN WAVE
-			seq_loadsequence(panel_open_close_wave, SEQ_SIZE(panel_open_close_wave));
+			seq_loadgenerator(&panel_open_close_wave);
 			seq_resetspeed();
 			HPFlash(5); 	 					// HPs flash for 5 seconds
 			SoundOpenWave(); 					// long happy sound
@@ -914,7 +937,7 @@ void sequence_command(uint8_t value)
 
 		case 5: // Beep Cantina (R2 beeping the cantina, panels doing marching ants)
 			seq_add_completion_callback(resetJEDIcallback); 	// callback to reset displays at end of sequence
-			seq_loadsequence(panel_marching_ants, SEQ_SIZE(panel_marching_ants));
+			seq_loadgenerator(&panel_marching_ants);
 			seq_loadspeed(panel_slow_speed);					// slow speed marching ants
 			DisplaySpectrum();	 								// spectrum display
 			HPFlash(17); 	 									// HPs flash for 17 seconds
@@ -936,7 +959,7 @@ void sequence_command(uint8_t value)
 
 		case 7: // Cantina (Orchestral Cantina, Rhythmic Panels)
 			seq_add_completion_callback(resetJEDIcallback); 	// callback to reset displays at end of sequence
-			seq_loadsequence(panel_dance, SEQ_SIZE(panel_dance));
+			seq_loadpacked(panel_dance);
 			seq_resetspeed();
 			SoundCantina();		 				// code for dance sound
 			DisplaySpectrum();	 				// spectrum display
@@ -961,7 +984,7 @@ void sequence_command(uint8_t value)
 		case 9:	// DISCO
 			seq_add_completion_callback(resetJEDIcallback); // callback to reset displays at end of sequence
 			seq_resetspeed();
-			seq_loadsequence(panel_long_disco, SEQ_SIZE(panel_long_disco)); // 6:26 seconds sequence
+			seq_loadpacked(panel_long_disco); // 6:26 seconds sequence
 			// message on the logics
 			//suart_puts("@1MR2 D2   \r"); 		// message is top front is R2
 			//_delay_ms(200);
@@ -1077,7 +1100,7 @@ void sequence_command(uint8_t value)
 		case 18:	// Star Wars DISCO
 			seq_add_completion_callback(resetJEDIcallback); // callback to reset displays at end of sequence
 			seq_resetspeed();
-			seq_loadsequence(panel_long_disco, SEQ_SIZE(panel_long_disco)); // 6:26 seconds sequence
+			seq_loadpacked(panel_long_disco); // 6:26 seconds sequence
 			// message on the logics
 			//suart_puts("@1MR2 D2   \r"); 		// message is top front is R2
 			//_delay_ms(200);
@@ -1097,7 +1120,7 @@ void sequence_command(uint8_t value)
 		case 19:	// Star Trek DISCO
 			seq_add_completion_callback(resetJEDIcallback); // callback to reset displays at end of sequence
 			seq_resetspeed();
-			seq_loadsequence(panel_long_disco, SEQ_SIZE(panel_long_disco)); // 6:26 seconds sequence
+			seq_loadpacked(panel_long_disco); // 6:26 seconds sequence
 			// message on the logics
 			//suart_puts("@1MR2 D2   \r"); 		// message is top front is R2
 			//_delay_ms(200);
@@ -1134,25 +1157,25 @@ void sequence_command(uint8_t value)
 			if(feedbackmessageon) serial_puts_p(strSeqScream);
 			break;
 		case 52: // WAVE1
-			seq_loadsequence(panel_wave, SEQ_SIZE(panel_wave));
+			seq_loadgenerator(&panel_wave);
 			seq_resetspeed();
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqWave);
 			break;
 		case 53: // MOODY FAST WAVE
-			seq_loadsequence(panel_fast_wave, SEQ_SIZE(panel_fast_wave));
+			seq_loadgenerator(&panel_fast_wave);
 			seq_resetspeed();
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqFastWave);
 			break;
 		case 54: // WAVE2
-			seq_loadsequence(panel_open_close_wave, SEQ_SIZE(panel_open_close_wave));
+			seq_loadgenerator(&panel_open_close_wave);
 			seq_resetspeed();
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqOpenCloseWave);
 			break;
 		case 55: // Marching ant
-			seq_loadsequence(panel_marching_ants, SEQ_SIZE(panel_marching_ants));
+			seq_loadgenerator(&panel_marching_ants);
 			seq_loadspeed(panel_slow_speed);	// softer close
 			seq_startsequence();
 			if(feedbackmessageon) serial_puts_p(strSeqMarchingAnts);
@@ -1164,7 +1187,7 @@ void sequence_command(uint8_t value)
 			if(feedbackmessageon) serial_puts_p(strSeqShortCircuit);
 			break;
 		case 57: // Rhythmic Panels
-			seq_loadsequence(panel_dance, SEQ_SIZE(panel_dance));
+			seq_loadpacked(panel_dance);
 			seq_resetspeed();
 			if(feedbackmessageon) serial_puts_p(strSeqRythmicPanels);
 			seq_startsequence();
@@ -1178,7 +1201,14 @@ void sequence_command(uint8_t value)
 	}
 }
 
-
+// flash saved by the packed sequences of panel_sequences.h
+void report_packed_sequences()
+{
+	char string[60];
+	sprintf(string, "(Packed dance %d, disco %d bytes saved) \r\n",
+			SEQ_PACKED_SAVED(panel_dance), SEQ_PACKED_SAVED(panel_long_disco));
+	serial_puts(string);
+}
 
 
 void open_command(uint8_t value)
@@ -1186,10 +1216,12 @@ void open_command(uint8_t value)
 	uint8_t i;
 	if(value==0) // open all
 	{
+		servo_stage_begin();	// all panels start moving in the same servo frame
 		for (i=1; i<=SERVO_NUM; i++)
 		{
 			servo_set(i, _OPN);
 		}
+		servo_stage_commit();
 		return;
 	}
 	if(value<=SERVO_NUM) // open specific panel
@@ -1199,18 +1231,22 @@ void open_command(uint8_t value)
 	}
 	if(value==11) // open top panels
 	{
+		servo_stage_begin();
 		for (i=7; i<=SERVO_NUM; i++)
 		{
 			servo_set(i, _OPN);
 		}
+		servo_stage_commit();
 		return;
 	}
 	if(value==12) // open bottom panels
 	{
+		servo_stage_begin();
 		for (i=1; i<=6; i++)
 		{
 			servo_set(i, _OPN);
 		}
+		servo_stage_commit();
 		return;
 	}
 }
@@ -1273,11 +1309,13 @@ void stop_command(uint8_t value)
 	// all panels hold to last position and servo off
 	if(value==0)
 	{
+		servo_stage_begin();
 		for(i=1; i<=SERVO_NUM; i++)
 		 {
 			 panel_rc_control[i-1]=0;
 			 servo_set(i,SERVO_NO_PULSE);
 		 }
+		servo_stage_commit();
 		return;
 	}
 
@@ -1307,6 +1345,17 @@ void hold_command(uint8_t value)
 	panel_rc_control[value-1]=0;
 }
 
+void tempo_command(uint8_t value)
+{
+	// playback rate of the running and next sequences, 50 is normal, 1% per step
+	uint16_t percent;
+	if(value>99) return;
+
+	if(value==0) percent=100;	// back to normal
+	else percent=value+50;
+	seq_settempo(((uint32_t)percent*SEQ_TEMPO_NORMAL+50)/100);
+}
+
 // sets JEDI display and Holos in their default state
 void init_jedi()
 {
@@ -64,6 +64,21 @@
 #define _OPN 1000
 #define _CLS 2000
 
+// SEQ_CLOSE, SEQ_OPEN and SEQ_MID position of each servo in packed sequences
+seq_positions_t const panel_positions PROGMEM =
+{
+		SEQ_POSITION(_CLS, _OPN),	// servo1
+		SEQ_POSITION(_CLS, _OPN),	// servo2
+		SEQ_POSITION(_CLS, _OPN),	// servo3
+		SEQ_POSITION(_CLS, _OPN),	// servo4
+		SEQ_POSITION(_CLS, _OPN),	// servo5
+		SEQ_POSITION(_CLS, _OPN),	// servo6
+		SEQ_POSITION(_CLS, _OPN),	// servo7
+		SEQ_POSITION(_CLS, _OPN),	// servo8
+		SEQ_POSITION(_CLS, _OPN),	// servo9
+		SEQ_POSITION(_CLS, _OPN),	// servo10
+};
+
 
 
 
@@ -118,213 +133,137 @@ sequence_t const panel_maxstang_wiggle PROGMEM =
 
 //Eebel Code END
 
-sequence_t const panel_wave PROGMEM =
+// the waves and the marching ants are computed by the sequencer, see "Generated sequences" in sequencer.h
+seq_gen_t const panel_wave PROGMEM =
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{30, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_GEN_WAVE, 0,				// one panel at a time
+		0x3FF, 1,						// servos 1 to 10, once
+		30, 30, 0, 30,					// first, pattern, hold and closing frame times
+		0								// panel_positions
 };
 
-sequence_t const panel_fast_wave PROGMEM=
+seq_gen_t const panel_fast_wave PROGMEM=
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_GEN_WAVE, SEQ_GEN_BOUNCE,	// back and forth
+		0x3FF, 1,						// servos 1 to 10, once
+		15, 15, 0, 15,					// first, pattern, hold and closing frame times
+		0								// panel_positions
 };
 
 
 
-sequence_t const panel_open_close_wave PROGMEM=
+seq_gen_t const panel_open_close_wave PROGMEM=
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_CLS, 	_CLS},
-		{20, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_CLS},
-		{80, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_OPN},
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{40, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_GEN_FILL, 0,				// open progressively, then close one by one
+		0x3FF, 1,						// servos 1 to 10, once
+		20, 20, 80, 40,					// first, pattern, hold (all open) and closing frame times
+		0								// panel_positions
 };
 
-sequence_t const panel_marching_ants PROGMEM =
+seq_gen_t const panel_marching_ants PROGMEM =
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{50, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{50, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{100, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_GEN_ANTS, 0,
+		0x3FF, 15,						// servos 1 to 10, 15 times odd servos then even servos
+		20, 50, 0, 100,					// first, pattern, hold and closing frame times
+		0								// panel_positions
 };
 
-sequence_t const panel_dance PROGMEM =
+// the longer sequences are packed to save flash, see "Packed sequences" in sequencer.h
+seq_packed_t const panel_dance PROGMEM =
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{20, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 4 pie, 1 by one
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 4 side, 1 by one
-		{45, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 4 pies. 2 by 2
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 2 large sides
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // interleaved
-		{45, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 2nd interleaved
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS,	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS,	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, //
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN,	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, //
-		{45, 	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_CLS, 	_CLS,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_CLS, 	_CLS,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // transition
-		{45, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS}, // Good
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS, 	_OPN, 	_CLS,	_OPN, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN, 	_CLS, 	_OPN,	_CLS, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_OPN,	_OPN, 	_OPN},
-		{45, 	_OPN, 	_OPN, 	_OPN, 	_OPN,	_OPN, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{45, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_FRAMES(90),
+		// time	servos		positions of the servos that change, in servo order
+		SEQ_T1(20),	SEQ_M(0x3FF), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), // 4 pie, 1 by one
+		SEQ_T1(45),	SEQ_M(0x040), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x080), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x100), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x200), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x200), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x100), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x080), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x040), SEQ_US(_CLS), // 4 side, 1 by one
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x002), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x004), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x008), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x002), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x004), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x008), SEQ_US(_CLS), // 4 pies. 2 by 2
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS), // 2 large sides
+		SEQ_T1(45),	SEQ_M(0x010), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x010), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x020), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x020), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x03F), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x006), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x038), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), // interleaved
+		SEQ_T1(45),	SEQ_M(0x00A), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x00A), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x005), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x005), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_CLS), SEQ_US(_CLS), // 2nd interleaved
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3D5), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x155), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), //
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3D5), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x155), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), //
+		SEQ_T1(45),	SEQ_M(0x003), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x00F), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x03C), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x030), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x333), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x333), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), // transition
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x002), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x002), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x007), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x001), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x002), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x004), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_OPN), SEQ_US(_OPN), // Good
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x280), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x3C0), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x140), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x155), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x155), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x2AA), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x2AA), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN),
+		SEQ_T1(45),	SEQ_M(0x03F), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x3FF), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_OPN), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(45),	SEQ_M(0x03F), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(0),	SEQ_M(0x3FF), SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP,
+		SEQ_END
 };
 sequence_t const panel_init PROGMEM =
 {
@@ -334,35 +273,37 @@ sequence_t const panel_init PROGMEM =
 };
 
 // 6min26sec disco sequence to trigger callback at the right time
-sequence_t const panel_long_disco PROGMEM=
+seq_packed_t const panel_long_disco PROGMEM =
 {
-		// time	servo1	servo2	servo3	servo4	servo5	servo6	servo7	servo8	servo9 servo10
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_OPN,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_OPN, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_OPN, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_OPN, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS},
-		{15, 	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS, 	_CLS, 	_CLS,	_CLS, 	_CLS}, // 3.45 seconds
-		{36000, _NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP},  // 6 minutes
-		{2200, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP},  // 22 seconds
-		{0, 	_NP, 	_NP, 	_NP, 	_NP,	_NP, 	_NP, 	_NP, 	_NP, 	_NP,	_NP}
+		SEQ_FRAMES(26),
+		// time	servos		positions of the servos that change, in servo order
+		SEQ_T1(15),	SEQ_M(0x3FF), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x001), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x003), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x006), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x00C), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x018), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x030), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x060), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x0C0), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x180), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x300), SEQ_US(_CLS), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x200), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x200), SEQ_US(_OPN),
+		SEQ_T1(15),	SEQ_M(0x300), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x180), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x0C0), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x060), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x030), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x018), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x00C), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x006), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x003), SEQ_US(_OPN), SEQ_US(_CLS),
+		SEQ_T1(15),	SEQ_M(0x001), SEQ_US(_CLS), // 3.45 seconds
+		SEQ_T3(36000),	SEQ_M(0x3FF), SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, SEQ_NP, // 6 minutes
+		SEQ_T2(2200),	SEQ_M(0x000), // 22 seconds
+		SEQ_T1(0),	SEQ_M(0x000),
+		SEQ_END
 };
 int16_t panel_fast_speed[]={0,0,0,0,0,0,0,0,0,0};
 
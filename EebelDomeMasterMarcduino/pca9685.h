@@ -0,0 +1,57 @@
+/*
+ * pca9685.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *      Servo outputs on PCA9685 16 channel PWM boards, over the I2C bus of the MarcDuino v2
+ *      Uses i2c.c (and realtime.c for its timeout)
+ *      The PWM is generated by the PCA9685, so these servos cost no TIMER1 interrupt time
+ *
+ *      Usage:
+ *      Uncomment SERVO_PCA9685 below, then:
+ *      pca9685_init();		// after i2c_init(), sets up all boards at 50 Hz, servos off
+ *      pca9685_set( channel (between 1 and PCA9685_SERVO_NUM), value between 500 and 2500);
+ *      pca9685_set( channel, -1); // will stop that particular servo
+ *      pca9685_task();		// call from the main loop, sends the changed channels
+ *
+ *      pca9685_set() only stages the value, it can be called from interrupts.
+ *      pca9685_task() sends the changed channels of each board in one auto-increment
+ *      write. It must not be called from an interrupt (i2c timeout needs realtime.c).
+ *      Normally used through servo_out.h, which numbers these channels after SERVO_NUM.
+ */
+
+#ifndef PCA9685_H_
+#define PCA9685_H_
+
+#include <stdint.h>
+
+// uncomment to drive more servos from PCA9685 boards (MarcDuino v2 only)
+// #define SERVO_PCA9685
+
+#define PCA9685_ADDRESS		0x40	// 7 bit address of the first board, the next boards follow
+#define PCA9685_BOARDS		1		// number of boards, 16 channels each
+#define PCA9685_SERVO_NUM	(16*PCA9685_BOARDS)
+
+#define PCA9685_OSC			25000000UL	// internal oscillator
+#define PCA9685_PRESCALE	121			// 25 MHz/(4096*(121+1)) = 50 Hz servo refresh
+
+// registers
+#define PCA9685_MODE1		0x00
+#define PCA9685_MODE2		0x01
+#define PCA9685_LED0_ON_L	0x06		// 4 registers per channel, ON_L, ON_H, OFF_L, OFF_H
+#define PCA9685_PRE_SCALE	0xFE
+
+#define PCA9685_MODE1_AI	0x20		// register auto-increment
+#define PCA9685_MODE1_SLEEP	0x10
+#define PCA9685_MODE1_RESTART 0x80
+#define PCA9685_MODE2_OUTDRV 0x04		// totem pole outputs
+#define PCA9685_FULL_OFF	0x10		// in OFF_H
+
+void pca9685_init();
+void pca9685_set(uint8_t channel, int16_t value);
+int16_t pca9685_read(uint8_t channel);
+void pca9685_stage_begin();
+void pca9685_stage_commit();
+void pca9685_task();
+
+#endif /* PCA9685_H_ */
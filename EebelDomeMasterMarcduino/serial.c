@@ -17,6 +17,11 @@
  *  v2.1 06.01/2015
  *  - made serial_puts wait if output buffer is full
  *  - created serial_puts_nowait if no waiting is required (faster too for fast serial speeds)
+ *  v2.2
+ *  - lock free fifo, buffer sizes are powers of two
+ *  - serial_puts waits only while the output buffer is full, not until it is empty
+ *  - count the characters dropped by a full output buffer, serial_tx_dropped()
+ *  - optional line input: the receive interrupt assembles whole lines, see SERIAL_LINE_INPUT
  *
  *************************************/
 
@@ -27,13 +32,37 @@
 #include "fifo.h"
 
 // Fifo buffers for input and output
+#if !FIFO_SIZE_OK(BUFSIZE_IN) || !FIFO_SIZE_OK(BUFSIZE_OUT)
+#error serial buffer sizes must be powers of two
+#endif
+
+#ifdef SERIAL_LINE_INPUT
+
+#if !FIFO_SIZE_OK(SERIAL_LINES)
+#error SERIAL_LINES must be a power of two
+#endif
+
+// Line buffers, used in turn. The interrupt receives into line_head, the complete lines
+// are line_tail up to line_head. Each side only moves its own index.
+char serial_lines[SERIAL_LINES][SERIAL_LINE_LENGTH];
+uint8_t volatile line_head;
+uint8_t volatile line_tail;
+uint8_t line_pos;				// interrupt only
+uint8_t volatile linesdropped;
+
+#else
 
 uint8_t inbuf[BUFSIZE_IN];
 fifo_t infifo;
 
+#endif
+
 uint8_t outbuf[BUFSIZE_OUT];
 fifo_t outfifo;
 
+// characters lost to a full output buffer
+uint16_t outdropped;
+
 
 void serial_init(uint16_t baudrate)
 {
@@ -118,8 +147,14 @@ void serial_init(uint16_t baudrate)
     // adding it back, or forgetting might not allow serial to work
     sei();
     // Initialize input and output FIFOs
+#ifdef SERIAL_LINE_INPUT
+    line_head=line_tail=line_pos=0;
+    linesdropped=0;
+#else
     fifo_init (&infifo,   inbuf, BUFSIZE_IN);
+#endif
     fifo_init (&outfifo, outbuf, BUFSIZE_OUT);
+    outdropped=0;
 }
 
 void serial_init_9600b8N1(void) // 9600 bauds, 8 bits, 1 stop, no parity
@@ -163,11 +198,40 @@ void serial_disable_rx_interrupt(void)
 // generic one not implemented yet
 //void uart1_init(int baudrate, int databits, int stopbits, int parity){}
 
+#ifdef SERIAL_LINE_INPUT
+// Input Interrupt - append to the line being received, hand it over at the end character
+ISR (USART_RX_vect)
+{
+	char ch=UDR0;
+	char* line=serial_lines[line_head];
+	uint8_t next;
+
+	if(ch!=SERIAL_LINE_END)
+	{
+		if(line_pos<SERIAL_LINE_LENGTH-1) line[line_pos++]=ch;	// too many characters, discard them
+		return;
+	}
+
+	line[line_pos]='\0';
+	line_pos=0;
+	next=(line_head+1) & (SERIAL_LINES-1);
+	// no free buffer, the line is dropped and its buffer reused
+	if(next==line_tail)
+	{
+		linesdropped++;
+		return;
+	}
+	fifo_barrier();			// the line is complete before it is handed over
+	line_head=next;
+}
+#else
 // Input Interrupt - can't do any simpler, just store input in FIFO...
+// (the main loop is the only reader, no interrupt locking needed)
 ISR (USART_RX_vect)
 {
     _inline_fifo_put (&infifo, UDR0);
 }
+#endif
 
 // Output Interrupt
 // Read a byte from the output fifo and send it
@@ -177,7 +241,7 @@ ISR (USART_RX_vect)
 ISR(USART_UDRE_vect)
 {
     // send out byte if there is one waiting
-	if (outfifo.count > 0)
+	if (fifo_count(&outfifo))
        UDR0 = _inline_fifo_get (&outfifo);
 	// no more bytes, deactivate send interrupts
     else
@@ -190,24 +254,46 @@ uint8_t serial_putc(unsigned char ch)
 {
 	// add character to output buffer
 	uint8_t ret = fifo_put (&outfifo, ch);
+	if(!ret) outdropped++;
 	// set interrupt on empty out queue to call ISR
 	UCSR0B |= (1 << UDRIE0);
 	return ret;
 }
 
+// wait for room in the output buffer, then add the character
+static void serial_putc_wait(unsigned char ch)
+{
+	while(!fifo_space(&outfifo)){};
+	serial_putc(ch);
+}
+
+#ifndef SERIAL_LINE_INPUT
 // check if receive characters available
 uint8_t serial_available()
 {
 	return fifo_available(&infifo);
 }
+#endif
 
-// check if ready to transmit (output buffer full)
-// use this one to wait and avoid overrunning the output buffer
+// check if everything was sent (output buffer empty)
 uint8_t serial_tx_complete()
 {
 	return !fifo_available(&outfifo);
 }
 
+// room left in the output buffer, use this one to avoid overrunning it
+uint8_t serial_tx_space()
+{
+	return fifo_space(&outfifo);
+}
+
+// number of characters lost because the output buffer was full, since init
+uint16_t serial_tx_dropped()
+{
+	return outdropped;
+}
+
+#ifndef SERIAL_LINE_INPUT
 // this one is only valid if some char available, if not returns 0xFF
 // so check serial_available() beforehand
 unsigned char serial_getc (void)
@@ -225,22 +311,49 @@ unsigned char serial_getc_wait (void)
 {
     return fifo_get_wait (&infifo);
 }
+#endif
 
-// If the output buffer is full, this will wait for serial buffer clear before returning
+#ifdef SERIAL_LINE_INPUT
+// returns the index of the oldest complete line, -1 if there is none
+// the line stays put until serial_line_release(), it can be used in place
+int8_t serial_line_get(void)
+{
+	if(line_tail==line_head) return -1;
+	return line_tail;
+}
+
+char* serial_line(uint8_t index)
+{
+	return serial_lines[index];
+}
+
+// lines are released in the order they came
+void serial_line_release(void)
+{
+	fifo_barrier();			// done reading the line before giving it back
+	if(line_tail!=line_head) line_tail=(line_tail+1) & (SERIAL_LINES-1);
+}
+
+uint8_t serial_lines_dropped(void)
+{
+	return linesdropped;
+}
+#endif
+
+// If the output buffer is full, this will wait for room in it before returning
 // all characters are sent guaranteed
 void serial_puts(char* string)
 {
 	uint8_t i=0;
 	while( (string[i]!='\0') & (i<255))
 	{
-		while(!serial_tx_complete()){};
-		serial_putc(string[i]);
+		serial_putc_wait(string[i]);
 	 	i++;
 	}
 }
 
 //this version will return no matter what, not waiting for serial buffer to clear
-//if the output buffer is full some character will be lost
+//if the output buffer is full some character will be lost, and counted in serial_tx_dropped()
 uint8_t serial_puts_nowait(char* string)
 {
 	uint8_t i=0;
@@ -267,10 +380,18 @@ void serial_puts_p(const char *progmem_s )
     register char c;
 
     while ( (c = pgm_read_byte(progmem_s++)) )
-    {
-    	while(!serial_tx_complete()){};	// wait for serial buffer availability
-    	serial_putc(c);
-    }
+    	serial_putc_wait(c);	// waits only if the buffer is full
+}
+
+// same, never waits. Returns 0 if some characters were lost.
+uint8_t serial_puts_p_nowait(const char *progmem_s )
+{
+    register char c;
+    uint8_t noerror=1;
+
+    while ( (c = pgm_read_byte(progmem_s++)) )
+    	noerror &= serial_putc(c);
+    return noerror;
 }
 
 
@@ -17,6 +17,11 @@
  *  v2.1 06.01/2015
  *  - made serial_puts wait if output buffer is full
  *  - created serial_puts_nowait if no waiting is required (faster too for fast serial speeds)
+ *  v2.2
+ *  - lock free fifo, buffer sizes are powers of two
+ *  - serial_puts waits only while the output buffer is full, not until it is empty
+ *  - count the characters dropped by a full output buffer, serial_tx_dropped()
+ *  - optional line input: the receive interrupt assembles whole lines, see SERIAL_LINE_INPUT
  *
  *************************************/
 
@@ -31,9 +36,21 @@
 #define _HAS_UART1_
 #endif
 
-// you can change the default ring buffer sizes here
+// you can change the default ring buffer sizes here, powers of two up to 0x100
+// (they hold one byte less)
 #define BUFSIZE_IN  0x40
-#define BUFSIZE_OUT 0xFF
+#define BUFSIZE_OUT 0x100
+
+// Line input. The receive interrupt assembles the lines ending with SERIAL_LINE_END
+// in a pool of SERIAL_LINES buffers, and the main loop gets them whole with serial_line_get().
+// Longer lines are cut to SERIAL_LINE_LENGTH-1 characters, the rest is lost. A line arriving
+// while all the buffers are waiting is dropped and counted in serial_lines_dropped(): with 4
+// buffers, 3 lines can wait while a slow command (display effects block up to 300 ms) runs.
+// Comment out to read characters one by one with serial_getc() instead.
+#define SERIAL_LINE_INPUT
+#define SERIAL_LINES		4		// power of two, one of them is being received
+#define SERIAL_LINE_LENGTH	64		// including the '\0' terminator
+#define SERIAL_LINE_END		'\r'
 
 #define PARITYNONE 0
 #define PARITYODD 1
@@ -52,20 +69,30 @@ void serial_init_9600b7E1(void); 		// 9600 bauds, 7 bits, 1 stop, no parity
 
 /********* sending ***********/
 uint8_t serial_tx_complete();			// use to check if the output buffer has emptied before sending more if you need flow control
+uint8_t serial_tx_space();				// room left in the output buffer
+uint16_t serial_tx_dropped();			// characters lost to a full output buffer since init
 uint8_t serial_putc(unsigned char ch);	// returns 0 if output buffer was full
-void serial_puts(char* string);			// send string, waits for output buffer to clear if full
+void serial_puts(char* string);			// send string, waits for room in the output buffer only if it is full
 uint8_t serial_puts_nowait(char* string);  // send string, returns immediately, if output buffer is full char will be lost and it will return 0
 void serial_puts_p(const char *progmem_s ); // for printing program memory strings
+uint8_t serial_puts_p_nowait(const char *progmem_s ); // same, never waits, returns 0 if chars were lost
 // this is how to use it
 // #include <avr/pgmspace.h> // optional, already included in this header
 // const char string[] PROGMEM = "Hello World";
 // serial_puts_p(string);
 
 /******** receiving **********/
+#ifdef SERIAL_LINE_INPUT
+int8_t serial_line_get(void);			// index of the oldest complete line, -1 if none
+char* serial_line(uint8_t index);		// the line, '\0' terminated without the end character
+void serial_line_release(void);			// done with the oldest line, its buffer can be reused
+uint8_t serial_lines_dropped(void);		// lines lost because all the buffers were waiting
+#else
 uint8_t serial_available();				// call this first before calling the next one...
 unsigned char serial_getc (void);		// returns right away, with 0xFF if no character available
 int8_t serial_getc_nowait (void);		// returns -1 if no char, works if expecting 7 bit ASCII
 unsigned char serial_getc_wait (void);  // blocks until a character is available
+#endif
 
 /***** Receive Interrupt Enable **********/
 void serial_enable_rx_interrupt(void);	// on by default after init
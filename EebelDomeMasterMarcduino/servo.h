@@ -31,6 +31,13 @@
  *		Added preliminary support for servo reversing
  *		Right now all servos reversed. I'll need to add 1:1 reversing with EEPROM control later
  *		(#define _REVERSE_SERVOS_ if you want them reversed)
+ *
+ *		Revised: Oct 19, 2026
+ *		All servo pulses start together at the beginning of a fixed 20 ms frame
+ *		and end in pulse length order. Timer 1 now runs in CTC mode (TOP=OCR1A).
+ *		Port/bit mask and pulse end are precomputed, the interrupts only do port writes.
+ *		servo_set() stages values, they are published together at the next frame start
+ *		(see servo_stage_begin() / servo_stage_commit()).
  */
 
 #ifndef SERVO_H_
@@ -102,13 +109,14 @@
 #define SERVO_PULSE_MAX		2500
 #define SERVO_PULSE_CENTER	1500
 
-// pause between servo pulse trains in 0.5 us increments
-#ifdef SERVO_RCINPUT
-	//#define SERVO_PULSE_PAUSE -17536	// make it 1.5x16 ms (65536-17536/2=24ms) if reading pulses
-	#define SERVO_PULSE_PAUSE -20000	// a little more responsive for 10 servos
-	#else								// so we can be sure to read at least pulse during the pause time
-	#define SERVO_PULSE_PAUSE 32000		// if not, regular pause is 16 ms
-#endif
+// servo frame length in 0.5 us increments. All pulses start together at the
+// beginning of the frame, so the refresh rate does not depend on the number of servos
+// The RC input is read over the whole frame
+#define SERVO_FRAME			40000		// 20 ms
+
+// pulses ending closer than this to the previous one are ended from the same
+// interrupt instead of their own, in 0.5 us increments
+#define SERVO_EDGE_MARGIN	16
 
 #define SERVO_NO_PULSE -1			// pass -1 for no pulse output on that particular servo
 
@@ -132,10 +140,26 @@ void servo_stop();
  * Values are stored as double that in counter tick values
  * (each counter tick is 0.5 us)
  * in the global array servo_value[]
+ * The value is staged, the servo moves at the next frame start
  *****************************************************/
 void servo_set(uint8_t servo, int16_t value);
 int16_t servo_read(uint8_t servo);
 
+/*****************************************************
+ * Staged servo updates
+ * All values staged by servo_set() are published together
+ * at the start of the next servo frame, except while a writer
+ * is between servo_stage_begin() and servo_stage_commit():
+ * then they wait for the following frame.
+ * The commit of the last writer builds the new schedule,
+ * the frame start interrupt only swaps it in.
+ * Wrap servo_set() calls that must land in the same frame
+ * (moving several panels together) with these. Calls can nest,
+ * and can be made from the main loop or from interrupts.
+ *****************************************************/
+void servo_stage_begin();
+void servo_stage_commit();
+
 
 #ifdef SERVO_RCINPUT
 /*****************************
@@ -47,10 +47,12 @@ void Sabertooth::autobaud(SabertoothStream& port, boolean dontWait)
 
 void Sabertooth::command(byte command, byte value) const
 {
-  port().write(address());
-  port().write(command);
-  port().write(value);
-  port().write((address() + command + value) & B01111111);
+  byte packet[4];
+  packet[0] = address();
+  packet[1] = command;
+  packet[2] = value;
+  packet[3] = (address() + command + value) & B01111111;
+  port().write(packet, sizeof(packet));
 }
 
 void Sabertooth::throttleCommand(byte command, int power) const
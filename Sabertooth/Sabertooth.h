@@ -176,4 +176,166 @@ private:
   SabertoothStream& _port; 
 };
 
+/*!
+\class SabertoothBurst
+\brief Builds Packet Serial commands in a buffer so several of them can be sent with a single write().
+The driver address is a template parameter, so the address byte and most of the checksum are constants.
+\tparam Capacity The buffer size in bytes. Each command takes 4 bytes.
+*/
+template <byte Capacity>
+class SabertoothBurst
+{
+public:
+  /*!
+  Initializes a new, empty burst.
+  */
+  SabertoothBurst() : _length(0) { }
+  
+  /*!
+  Gets the number of bytes waiting to be sent.
+  \return The number of bytes in the buffer.
+  */
+  inline byte length() const { return _length; }
+  
+  /*!
+  Adds a packet serial command. The command is dropped if the buffer is full.
+  \tparam Address The driver address.
+  \param  command The number of the command.
+  \param  value   The command's value.
+  */
+  template <byte Address>
+  void command(byte command, byte value)
+  {
+    if (_length > Capacity - 4) { return; }
+    byte* packet = _buffer + _length;
+    packet[0] = Address;
+    packet[1] = command;
+    packet[2] = value;
+    packet[3] = (Address + command + value) & B01111111;
+    _length += 4;
+  }
+  
+  /*!
+  Adds a motor power command.
+  \tparam Address The driver address.
+  \param  motor   The motor number, 1 or 2.
+  \param  power   The power, between -127 and 127.
+  */
+  template <byte Address>
+  void motor(byte motor, int power)
+  {
+    if (motor < 1 || motor > 2) { return; }
+    throttleCommand<Address>((motor == 2 ? 4 : 0) + (power < 0 ? 1 : 0), power);
+  }
+  
+  /*!
+  Adds a driving power command.
+  \tparam Address The driver address.
+  \param  power   The power, between -127 and 127.
+  */
+  template <byte Address>
+  void drive(int power) { throttleCommand<Address>(power < 0 ? 9 : 8, power); }
+  
+  /*!
+  Adds a turning power command.
+  \tparam Address The driver address.
+  \param  power   The power, between -127 and 127.
+  */
+  template <byte Address>
+  void turn(int power) { throttleCommand<Address>(power < 0 ? 11 : 10, power); }
+  
+  /*!
+  Adds the commands to stop both motors.
+  \tparam Address The driver address.
+  */
+  template <byte Address>
+  void stop() { motor<Address>(1, 0); motor<Address>(2, 0); }
+  
+  /*!
+  Sends everything in the buffer with one write() and empties it.
+  \param port The port to use.
+  */
+  void send(SabertoothStream& port)
+  {
+    if (_length > 0) { port.write(_buffer, _length); }
+    _length = 0;
+  }
+  
+private:
+  template <byte Address>
+  void throttleCommand(byte command, int power)
+  {
+    power = constrain(power, -126, 126);
+    this->command<Address>(command, (byte)abs(power));
+  }
+  
+private:
+  byte _buffer[Capacity];
+  byte _length;
+};
+
+/*!
+\class SabertoothFixed
+\brief Same interface as Sabertooth, for a driver address that is known at compile time.
+Each command is sent with a single write(), and stop() sends both of its packets in one.
+\tparam Address The driver address.
+*/
+template <byte Address>
+class SabertoothFixed
+{
+public:
+  /*!
+  Initializes a new instance of the SabertoothFixed class.
+  \param port The port to use.
+  */
+  SabertoothFixed(SabertoothStream& port) : _port(port) { }
+  
+public:
+  inline byte address() const { return Address; }
+  inline SabertoothStream& port() const { return _port; }
+  
+  void autobaud(boolean dontWait = false) const { Sabertooth::autobaud(_port, dontWait); }
+  static void autobaud(SabertoothStream& port, boolean dontWait = false) { Sabertooth::autobaud(port, dontWait); }
+  
+  void command(byte command, byte value) const
+  {
+    SabertoothBurst<4> burst; burst.template command<Address>(command, value); burst.send(_port);
+  }
+  
+public:
+  void motor(int power) const { motor(1, power); }
+  
+  void motor(byte motor, int power) const
+  {
+    SabertoothBurst<4> burst; burst.template motor<Address>(motor, power); burst.send(_port);
+  }
+  
+  void drive(int power) const
+  {
+    SabertoothBurst<4> burst; burst.template drive<Address>(power); burst.send(_port);
+  }
+  
+  void turn(int power) const
+  {
+    SabertoothBurst<4> burst; burst.template turn<Address>(power); burst.send(_port);
+  }
+  
+  void stop() const
+  {
+    SabertoothBurst<8> burst; burst.template stop<Address>(); burst.send(_port);
+  }
+  
+public:
+  // Configuration commands are rare, so they share the Sabertooth implementation.
+  void setMinVoltage(byte value) const { Sabertooth(Address, _port).setMinVoltage(value); }
+  void setMaxVoltage(byte value) const { Sabertooth(Address, _port).setMaxVoltage(value); }
+  void setBaudRate(long baudRate) const { Sabertooth(Address, _port).setBaudRate(baudRate); }
+  void setDeadband(byte value) const { Sabertooth(Address, _port).setDeadband(value); }
+  void setRamping(byte value) const { Sabertooth(Address, _port).setRamping(value); }
+  void setTimeout(int milliseconds) const { Sabertooth(Address, _port).setTimeout(milliseconds); }
+  
+private:
+  SabertoothStream& _port;
+};
+
 #endif
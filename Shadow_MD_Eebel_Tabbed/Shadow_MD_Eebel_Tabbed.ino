@@ -41,6 +41,7 @@
 //         NOTE:  Support for SyRen Simple Serial has been removed, due to problems.
 //         Please contact DimensionEngineering to get an RMA to flash your firmware
 //         Some place a 10K ohm resistor between S1 & GND on the SyRen 10 itself
+//         Simplified Serial is available again ONLY on its own port - see SYREN_SIMPLIFIED_SERIAL
 //
 // =======================================================================================
 //
@@ -32,6 +32,11 @@ byte ramping = 3;        // was 1...Ramping- the lower this number the longer R2
 byte joystickFootDeadZoneRange = 15;  // For controllers that centering problems, use the lowest number with no drift
 byte joystickDomeDeadZoneRange = 10;  // For controllers that centering problems, use the lowest number with no drift
 
+byte joystickFilterShift = 2;      // Stick low-pass strength: each read moves 1/(2^shift) of the way to the new value
+                                   // 0 = no filtering, 2 is a good start, 4 feels sluggish
+byte joystickHysteresisRange = 2;  // Filtered stick value must move more than this before a new setpoint is used
+                                   // 0 = off.  Keeps the stick from chattering on the dead zone edge
+
 byte driveDeadBandRange = 10;     // Used to set the Sabertooth DeadZone for foot motors
 
 int invertTurnDirection = -1;   //This may need to be set to 1 for some configurations
@@ -1718,11 +1723,32 @@ int FTbtnDown_L1_MD_func = 18; //was 35
 int motorControllerBaudRate = 9600; // Set the baud rate for the Syren motor controller
                                     // for packetized options are: 2400, 9600, 19200 and 38400
 
+long motorControllerFastBaudRate = 9600;  // Rate the Sabertooth and SyRen are switched to at startup (9600 = don't switch)
+                                          // Options: 19200, 38400, or 115200 (Sabertooth 2x32 ONLY - the SyRen 10 can't do it)
+                                          // Falls back to motorControllerBaudRate if the rate is invalid or the Mega UART
+                                          // can't generate it accurately
+                                          // The switch uses Packet Serial command 15, which the Sabertooth 2x32, 2x25 v2,
+                                          // 2x12 and SyRen 10/25 understand - older drivers ignore it, check the manual.
+                                          // Serial2 is TX only, so nothing confirms the switch: a driver that missed it stays
+                                          // at 9600 and stops taking commands.  The drivers SAVE the new rate in EEPROM, so
+                                          // another controller or an older sketch talking to them at 9600 no longer works
+                                          // until they are set back to 9600 with DEScribe (9600 here sends no command).
+
+unsigned long motorStartupDelay = 1500;   // ms after reset before the Sabertooth/SyRen are sent the autobaud character
+unsigned long motorAutobaudSettle = 500;  // ms the drivers get after autobaud before the first command
+
 int marcDuinoBaudRate = 9600; // Set the baud rate for the Syren motor controller
                                     
 #define SYREN_ADDR         129      // Serial Address for Dome Syren
 #define SABERTOOTH_ADDR    128      // Serial Address for Foot Sabertooth
 
+//#define SYREN_SIMPLIFIED_SERIAL         // uncomment to run the dome SyRen in Simplified Serial mode on its own port
+                                          // (1 byte per dome update, and none of the Serial2 foot bandwidth)
+                                          // It takes the body MarcDuino's port: no body MarcDuino commands are sent then
+#define SYREN_SIMPLIFIED_PORT    Serial3  // The only free port: Serial1 is the dome MarcDuino, Serial2 the foot drive
+#define SYREN_SIMPLIFIED_BAUD    9600     // Must match the SyRen DIP switches: 2400, 9600, 19200 or 38400
+#define SYREN_SIMPLIFIED_LATENCY 10       // ms between dome updates when the SyRen has its own port
+
 #define ENABLE_UHS_DEBUGGING 1
 
 // ---------------------------------------------------------------------------------------
@@ -1737,6 +1763,9 @@ int marcDuinoBaudRate = 9600; // Set the baud rate for the Syren motor controlle
 #endif
 
 #include <Sabertooth.h>
+#ifdef SYREN_SIMPLIFIED_SERIAL
+#include <SyRenSimplified.h>
+#endif
 
 // ---------------------------------------------------------------------------------------
 //                    Panel Management Variables
@@ -1811,8 +1840,94 @@ int marcDuinoButtonCounter = 0;
 int speedToggleButtonCounter = 0;
 int domeToggleButtonCounter = 0;
 
-Sabertooth *ST=new Sabertooth(SABERTOOTH_ADDR, Serial2);
-Sabertooth *SyR=new Sabertooth(SYREN_ADDR, Serial2);
+// Pass-through for Serial2 that counts every byte sent to the motor controllers.
+// Nothing goes out until open() - the drivers must see the autobaud character first.
+// The joystick filter was added without measured byte counts; compare the SHADOW_DEBUG
+// bus statistics on the droid with joystickFilterShift/joystickHysteresisRange at 0 and at their defaults.
+class MotorBusStream : public Stream
+{
+  public:
+    MotorBusStream(HardwareSerial& serial) : bytesSent(0), _serial(serial), _open(false) {}
+
+    void open() { _open = true; }
+
+    virtual size_t write(uint8_t b)
+    {
+      if (!_open) return 0;
+      bytesSent++;
+      return _serial.write(b);
+    }
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      if (!_open) return 0;
+      bytesSent += size;
+      return _serial.write(buffer, size);
+    }
+    virtual int available() { return _serial.available(); }
+    virtual int read() { return _serial.read(); }
+    virtual int peek() { return _serial.peek(); }
+    virtual void flush() { _serial.flush(); }
+
+    unsigned long bytesSent;
+
+  private:
+    HardwareSerial& _serial;
+    boolean _open;
+};
+
+// Motor controller startup, see motorBusStartup()
+#define MOTOR_BUS_POWERUP      0  // waiting for the drivers to power up
+#define MOTOR_BUS_AUTOBAUD     1  // autobaud sent, drivers settling
+#define MOTOR_BUS_BAUD_CHANGE  2  // drivers restarting on motorControllerFastBaudRate
+#define MOTOR_BUS_NEW_BAUD     3  // autobaud sent again at the new rate
+#define MOTOR_BUS_READY        4
+
+byte motorBusState = MOTOR_BUS_POWERUP;
+unsigned long motorBusStateMillis = 0;
+
+MotorBusStream motorSerial(Serial2);
+unsigned long previousMotorBusReportMillis = 0;
+unsigned long lastMotorBusReportBytes = 0;
+
+// Time spent in Usb.Task(), reported with the motor bus statistics.
+// The INT pin change was made without avg/max numbers from the droid; compare a build
+// with USE_UHS_INT_PIN set to 0 in the library's settings.h against the default.
+unsigned long usbTaskMicros = 0;
+unsigned long usbTaskMaxMicros = 0;
+unsigned long usbTaskCalls = 0;
+
+SabertoothFixed<SABERTOOTH_ADDR> *ST=new SabertoothFixed<SABERTOOTH_ADDR>(motorSerial);
+#ifdef SYREN_SIMPLIFIED_SERIAL
+// Simplified Serial has no serial timeout on the SyRen, so it is done here instead:
+// checkTimeout() stops the dome when no command was sent within the setTimeout() time,
+// just like the packetized SyRen does on its own.
+class SimplifiedDome
+{
+  public:
+    SimplifiedDome(Stream& port) : _syren(port), _lastCommandMillis(0), _timeout(0), _moving(false) {}
+
+    void motor(int power) { _syren.motor(power); _lastCommandMillis = millis(); _moving = (power != 0); }
+    void stop() { motor(0); }
+    
+    // Same rounding as Sabertooth::setTimeout() - up to the next 100ms
+    void setTimeout(int milliseconds) { _timeout = ((constrain(milliseconds, 0, 12700) + 99) / 100) * 100; }
+    
+    void checkTimeout()
+    {
+      if (_moving && _timeout > 0 && (millis() - _lastCommandMillis) > _timeout) stop();
+    }
+
+  private:
+    SyRenSimplified _syren;
+    unsigned long _lastCommandMillis;
+    unsigned long _timeout;
+    boolean _moving;
+};
+
+SimplifiedDome *SyR=new SimplifiedDome(SYREN_SIMPLIFIED_PORT);
+#else
+SabertoothFixed<SYREN_ADDR> *SyR=new SabertoothFixed<SYREN_ADDR>(motorSerial);
+#endif
 
 ///////Setup for USB and Bluetooth Devices////////////////////////////
 USB Usb;
@@ -1820,6 +1935,10 @@ BTD Btd(&Usb);
 PS3BT *PS3NavFoot=new PS3BT(&Btd);
 PS3BT *PS3NavDome=new PS3BT(&Btd);
 
+//Report sequence numbers seen by the button handling - it only runs when one of them changes
+uint16_t lastFootReport = 0;
+uint16_t lastDomeReport = 0;
+
 //Used for PS3 Fault Detection
 uint32_t msgLagTime = 0;
 uint32_t lastMsgTime = 0;
@@ -1859,3 +1978,14 @@ byte action = 0;
 unsigned long DriveMillis = 0;
 
 int footDriveSpeed = 0;
+
+// Stick filter state - see filterStickAxis()
+struct StickFilter
+{
+  int accum;    // smoothed value scaled by 2^joystickFilterShift
+  byte output;  // last value handed to the drive code
+};
+
+StickFilter footStickY;
+StickFilter footStickX;
+StickFilter domeStickX;
@@ -4,8 +4,13 @@
 void setup()
 {
     //Debug Serial for use with USB Debugging
+    //No waiting on Serial here - the droid has to boot the same with or without a host attached
     Serial.begin(115200);
-    while (!Serial);
+    
+    //Setup for Serial2:: Motor Controllers - Sabertooth (Feet) and SyRen (Dome)
+    //The drivers are autobauded and configured from loop() by motorBusStartup(),
+    //so their power up time overlaps the USB and Bluetooth setup below
+    Serial2.begin(motorControllerBaudRate);
     
     if (Usb.Init() == -1)
     {
@@ -22,21 +27,20 @@ void setup()
     Serial.print(F("\r\nInitFootNav"));
     PS3NavDome->attachOnInit(onInitPS3NavDome); 
 
-    //Setup for Serial2:: Motor Controllers - Sabertooth (Feet) 
-    Serial2.begin(motorControllerBaudRate);
-    ST->autobaud();          // Send the autobaud command to the Sabertooth controller(s).
-    ST->setTimeout(10);      //DMB:  How low can we go for safety reasons?  multiples of 100ms
-    ST->setDeadband(driveDeadBandRange);
-    ST->stop(); 
-    SyR->autobaud();
-    SyR->setTimeout(20);      //DMB:  How low can we go for safety reasons?  multiples of 100ms
-    SyR->stop(); 
+    resetStickFilter(footStickY);
+    resetStickFilter(footStickX);
+    resetStickFilter(domeStickX);
 
     //Setup for Serial1:: MarcDuino Dome Control Board
     Serial1.begin(marcDuinoBaudRate); 
     
-    //Setup for Serial3:: Optional MarcDuino Control Board for Body Panels
-    Serial3.begin(marcDuinoBaudRate);
+    #ifdef SYREN_SIMPLIFIED_SERIAL
+      //Setup for Serial3:: SyRen in Simplified Serial mode, no body MarcDuino
+      SYREN_SIMPLIFIED_PORT.begin(SYREN_SIMPLIFIED_BAUD);
+    #else
+      //Setup for Serial3:: Optional MarcDuino Control Board for Body Panels
+      Serial3.begin(marcDuinoBaudRate);
+    #endif
     
     randomSeed(analogRead(0));  // random number seed for dome automation 
 
@@ -12,6 +12,15 @@ void loop()
 
     //LOOP through functions from highest to lowest priority.
 
+    if (motorBusState != MOTOR_BUS_READY)
+    {
+      motorBusStartup();
+    }
+
+    #ifdef SYREN_SIMPLIFIED_SERIAL
+      SyR->checkTimeout();  // Also runs when readUSB() finds a fault and we skip the rest of the loop
+    #endif
+
     if ( !readUSB() )
     {
       //We have a fault condition that we want to ensure that we do NOT process any controller data!!!
@@ -21,9 +30,17 @@ void loop()
     
     footMotorDrive();
     domeDrive();
-    marcDuinoDome();
-    marcDuinoFoot();
-    toggleSettings();
+    
+    // The button combos only change when a controller sends a new report
+    if (newControllerInput())
+    {
+      marcDuinoDome();
+      marcDuinoFoot();
+      toggleSettings();
+    }
+    #ifdef SHADOW_DEBUG
+      reportBusStatistics();
+    #endif
     printOutput();
     
     // If running a custom MarcDuino Panel Routine - Call Function
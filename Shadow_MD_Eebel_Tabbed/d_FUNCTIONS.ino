@@ -1,4 +1,32 @@
 
+// =======================================================================================
+//           Stick Filter Section
+// =======================================================================================
+
+// Integer low-pass + hysteresis for one stick axis.  The raw Nav sticks jitter a few
+// counts, which turned into a stream of slightly different motor packets and start/stop
+// toggling at the dead zone edge.  Call once per read, before any curve or ramping.
+byte filterStickAxis(StickFilter &filter, byte raw)
+{
+    filter.accum += raw - (filter.accum >> joystickFilterShift);
+    
+    int smoothed = filter.accum >> joystickFilterShift;
+    
+    // Always let the stick reach its end stops, otherwise only move on a real change
+    if (abs(smoothed - filter.output) > joystickHysteresisRange || smoothed == 0 || smoothed == 255)
+    {
+        filter.output = smoothed;
+    }
+    
+    return filter.output;
+}
+
+void resetStickFilter(StickFilter &filter)
+{
+    filter.accum = 128 << joystickFilterShift;
+    filter.output = 128;
+}
+
 // =======================================================================================
 //           footDrive Motor Control Section
 // =======================================================================================
@@ -25,6 +53,8 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
               ST->stop();
               isFootMotorStopped = true;
               footDriveSpeed = 0;
+              resetStickFilter(footStickY);
+              resetStickFilter(footStickX);
               
               #ifdef SHADOW_VERBOSE      
                   output += "\r\n***Foot Motor STOPPED***\r\n";
@@ -41,6 +71,8 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
               ST->stop();
               isFootMotorStopped = true;
               footDriveSpeed = 0;
+              resetStickFilter(footStickY);
+              resetStickFilter(footStickX);
 
               #ifdef SHADOW_VERBOSE      
                   output += "\r\n***Foot Motor STOPPED***\r\n";
@@ -58,6 +90,8 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
               ST->stop();
               isFootMotorStopped = true;
               footDriveSpeed = 0;
+              resetStickFilter(footStickY);
+              resetStickFilter(footStickX);
 
               #ifdef SHADOW_VERBOSE      
                   output += "\r\n***Foot Motor STOPPED***\r\n";
@@ -69,7 +103,7 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
         
       } else
       {
-          int joystickPosition = myPS3->getAnalogHat(LeftHatY);
+          int joystickPosition = filterStickAxis(footStickY, myPS3->getAnalogHat(LeftHatY));
           
           if (overSpeedSelected) //Over throttle is selected
           {
@@ -176,17 +210,18 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
               }
           }
           
-          turnnum = (myPS3->getAnalogHat(LeftHatX));
+          int turnPosition = filterStickAxis(footStickX, myPS3->getAnalogHat(LeftHatX));
+          turnnum = turnPosition;
 
           //TODO:  Is there a better algorithm here?  
           if ( abs(footDriveSpeed) > 50)
-              turnnum = (map(myPS3->getAnalogHat(LeftHatX), 54, 200, -(turnspeed/4), (turnspeed/4)));
+              turnnum = (map(turnPosition, 54, 200, -(turnspeed/4), (turnspeed/4)));
           else if (turnnum <= 200 && turnnum >= 54)
-              turnnum = (map(myPS3->getAnalogHat(LeftHatX), 54, 200, -(turnspeed/3), (turnspeed/3)));
+              turnnum = (map(turnPosition, 54, 200, -(turnspeed/3), (turnspeed/3)));
           else if (turnnum > 200)
-              turnnum = (map(myPS3->getAnalogHat(LeftHatX), 201, 255, turnspeed/3, turnspeed));
+              turnnum = (map(turnPosition, 201, 255, turnspeed/3, turnspeed));
           else if (turnnum < 54)
-              turnnum = (map(myPS3->getAnalogHat(LeftHatX), 0, 53, -turnspeed, -(turnspeed/3)));
+              turnnum = (map(turnPosition, 0, 53, -turnspeed, -(turnspeed/3)));
               
           if (abs(turnnum) > 5)
           {
@@ -210,8 +245,11 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
                     output += millis();
                   #endif
               
-                  ST->turn(turnnum * invertTurnDirection);
-                  ST->drive(footDriveSpeed);
+                  // Turn and drive go out together in one write
+                  SabertoothBurst<8> footBurst;
+                  footBurst.turn<SABERTOOTH_ADDR>(turnnum * invertTurnDirection);
+                  footBurst.drive<SABERTOOTH_ADDR>(footDriveSpeed);
+                  footBurst.send(motorSerial);
                   
               } else
               {    
@@ -241,6 +279,7 @@ boolean ps3FootMotorDrive(PS3BT* myPS3 = PS3NavFoot)
 
 void footMotorDrive()
 {
+  if (motorBusState != MOTOR_BUS_READY) return;
 
   //Flood control prevention
   if ((millis() - previousFootMillis) < serialLatency) return;  
@@ -258,7 +297,7 @@ int ps3DomeDrive(PS3BT* myPS3 = PS3NavDome)
 {
     int domeRotationSpeed = 0;
       
-    int joystickPosition = myPS3->getAnalogHat(LeftHatX);
+    int joystickPosition = filterStickAxis(domeStickX, myPS3->getAnalogHat(LeftHatX));
         
     domeRotationSpeed = (map(joystickPosition, 0, 255, -domespeed, domespeed));
         
@@ -280,6 +319,15 @@ int ps3DomeDrive(PS3BT* myPS3 = PS3NavDome)
     return domeRotationSpeed;
 }
 
+int domeCommandLatency()
+{
+    #ifdef SYREN_SIMPLIFIED_SERIAL
+      return SYREN_SIMPLIFIED_LATENCY;  // own port, 1 byte per update
+    #else
+      return 2*serialLatency;           // shares Serial2 with the foot Sabertooth
+    #endif
+}
+
 void rotateDome(int domeRotationSpeed, String mesg)
 {
     //Constantly sending commands to the SyRen (Dome) is causing foot motor delay.
@@ -290,7 +338,7 @@ void rotateDome(int domeRotationSpeed, String mesg)
     // 4.) Reduce the timout of the SyRen - just better for safety!
     
     currentMillis = millis();
-    if ( (!isDomeMotorStopped || domeRotationSpeed != 0) && ((currentMillis - previousDomeMillis) > (2*serialLatency) )  )
+    if ( (!isDomeMotorStopped || domeRotationSpeed != 0) && ((currentMillis - previousDomeMillis) > domeCommandLatency() )  )
     {
       
           if (domeRotationSpeed != 0)
@@ -322,9 +370,10 @@ void rotateDome(int domeRotationSpeed, String mesg)
 
 void domeDrive()
 {
+  if (motorBusState != MOTOR_BUS_READY) return;
   //Flood control prevention
   //This is intentionally set to double the rate of the Dome Motor Latency
-  if ((millis() - previousDomeMillis) < (2*serialLatency) ) return;  
+  if ((millis() - previousDomeMillis) < domeCommandLatency() ) return;  
   
   int domeRotationSpeed = 0;
   int ps3NavControlSpeed = 0;
@@ -354,6 +403,7 @@ void domeDrive()
          SyR->stop();
          isDomeMotorStopped = true;
      }
+     resetStickFilter(domeStickX);
   }  
 }  
 
@@ -452,6 +502,18 @@ void toggleSettings()
    if (PS3NavFoot->PS3NavigationConnected) ps3ToggleSettings(PS3NavFoot);
 }  
 
+// =======================================================================================
+//           Body MarcDuino output - Serial3
+// =======================================================================================
+// A SyRen in Simplified Serial mode takes Serial3 over and would read every character
+// of a body command as a dome speed, so with SYREN_SIMPLIFIED_SERIAL nothing is sent.
+void sendBodyMarcDuino(const char* command)
+{
+    #ifndef SYREN_SIMPLIFIED_SERIAL
+      Serial3.print(command);
+    #endif
+}
+
 // =======================================================================================
 // This is the main MarcDuino Button Management Function
 // =======================================================================================
@@ -504,7 +566,7 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
       case 3:
         //Dome and Body Wave
         Serial1.print(":SE02\r");
-        Serial3.print(":SE02\r");
+        sendBodyMarcDuino(":SE02\r");
         break;
         
       case 4:
@@ -522,7 +584,7 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
       case 7:
         //Faint
         Serial1.print(":SE06\r");
-        Serial3.print(":SE06\r");
+        sendBodyMarcDuino(":SE06\r");
         break;
                 
       case 8:
@@ -624,12 +686,12 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
                 
       case 30:
         Serial1.print(":OP00\r");
-        Serial3.print(":OP04\r"); //Left Body Door
-        Serial3.print(":OP07\r"); //Right Body Door
+        sendBodyMarcDuino(":OP04\r"); //Left Body Door
+        sendBodyMarcDuino(":OP07\r"); //Right Body Door
         delay(550); //wait for Main Doors
-        Serial3.print(":OP01\r"); //DPL
+        sendBodyMarcDuino(":OP01\r"); //DPL
         Serial1.print(":ST00\r"); //Stop the buzz
-        Serial3.print(":ST00\r"); //Stop the buzz
+        sendBodyMarcDuino(":ST00\r"); //Stop the buzz
         
         break;
                 
@@ -643,7 +705,7 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
                 
       case 33:
         Serial1.print(":CL00\r");
-        Serial3.print(":CL00\r");
+        sendBodyMarcDuino(":CL00\r");
         break;
                 
       case 34:
@@ -727,160 +789,160 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
         break;
                 
       case 54:
-        Serial3.print(":OP00\r");
+        sendBodyMarcDuino(":OP00\r");
         break;
                 
       case 55:
-        Serial3.print(":CL00\r");
+        sendBodyMarcDuino(":CL00\r");
         break;
                 
       case 56:
         //Toggle Body Panel Data Panel Door
         if (DPLOpen == false){
-          Serial3.print(":OP01\r"); //Open the panel 
+          sendBodyMarcDuino(":OP01\r"); //Open the panel 
           delay(550); //give panel time to open
-          Serial3.print(":ST01\r"); //Stop the buzz
+          sendBodyMarcDuino(":ST01\r"); //Stop the buzz
           DPLOpen = true;
         } else {
           //Close Body Panel 1
-          Serial3.print(":CL01\r");
+          sendBodyMarcDuino(":CL01\r");
           DPLOpen = false;
         }
         break;
                 
       case 57:
         //Close Body Panel 1
-        Serial3.print(":CL01\r");
+        sendBodyMarcDuino(":CL01\r");
         break;
                 
       case 58:
       //Top Utility Arm Toggle
         if (TopUArmOpen == false){
-          Serial3.print(":OP02\r"); //Open the panel 
+          sendBodyMarcDuino(":OP02\r"); //Open the panel 
           delay(550); //give panel time to open
-          Serial3.print(":ST02\r"); //Stop the buzz
+          sendBodyMarcDuino(":ST02\r"); //Stop the buzz
           TopUArmOpen = true;
         } else {
           //Close Utility Arm Panel 2
-          Serial3.print(":CL02\r");
+          sendBodyMarcDuino(":CL02\r");
           TopUArmOpen = false;
         }
         break;
                 
       case 59:
-        Serial3.print(":CL02\r");
+        sendBodyMarcDuino(":CL02\r");
         break;
                 
       case 60:
         //Bottom Utility Arm Toggle
         if (BotUArmOpen == false){
-          Serial3.print(":OP03\r"); //Open the panel 
+          sendBodyMarcDuino(":OP03\r"); //Open the panel 
           delay(550); //give panel time to open
-          Serial3.print(":ST03\r"); //Stop the buzz
+          sendBodyMarcDuino(":ST03\r"); //Stop the buzz
           BotUArmOpen = true;
         } else {
           //Close Utility Arm Panel 2
-          Serial3.print(":CL03\r");
+          sendBodyMarcDuino(":CL03\r");
           BotUArmOpen = false;
         }
         break;
                 
       case 61:
-        Serial3.print(":CL03\r");
+        sendBodyMarcDuino(":CL03\r");
         break;
                 
       case 62:
         //Toggle Left Body Door Panel 4
         if (LeftDoorOpen == false){
-          Serial3.print(":OP04\r"); //Open the panel 4
+          sendBodyMarcDuino(":OP04\r"); //Open the panel 4
           delay(400); //give panel time to open
-          Serial3.print(":ST04\r"); //Stop the buzz
+          sendBodyMarcDuino(":ST04\r"); //Stop the buzz
           LeftDoorOpen = true;
         } else {
           //Close Left Door Panel 4
-          Serial3.print(":CL04\r");
+          sendBodyMarcDuino(":CL04\r");
           LeftDoorOpen = false;
         }
         break;
                 
       case 63:
-        Serial3.print(":CL04\r");
+        sendBodyMarcDuino(":CL04\r");
         break;
                 
       case 64:
-        Serial3.print(":OP05\r");
+        sendBodyMarcDuino(":OP05\r");
         break;
                 
       case 65:
-        Serial3.print(":CL05\r");
+        sendBodyMarcDuino(":CL05\r");
         break;
                 
       case 66:
-        Serial3.print(":OP06\r");
+        sendBodyMarcDuino(":OP06\r");
         break;
                 
       case 67:
-        Serial3.print(":CL06\r");
+        sendBodyMarcDuino(":CL06\r");
         break;
                 
       case 68:
         //Toggle Right Body Door Panel 7
         if (RightDoorOpen == false){
-          Serial3.print(":OP07\r"); //Open the panel 7
+          sendBodyMarcDuino(":OP07\r"); //Open the panel 7
           delay(400); //give panel time to open
-          Serial3.print(":ST07\r"); //Stop the buzz
+          sendBodyMarcDuino(":ST07\r"); //Stop the buzz
           RightDoorOpen = true;
         } else {
           //Close Right Door Panel 7
-          Serial3.print(":CL07\r");
+          sendBodyMarcDuino(":CL07\r");
           RightDoorOpen = false;
         }
         break;
                 
       case 69:
-        Serial3.print(":CL07\r");
+        sendBodyMarcDuino(":CL07\r");
         break;
                 
       case 70:
-        Serial3.print(":OP08\r");
+        sendBodyMarcDuino(":OP08\r");
         break;
                 
       case 71:
-        Serial3.print(":CL08\r");
+        sendBodyMarcDuino(":CL08\r");
         break;
                 
       case 72:
-        Serial3.print(":OP09\r");
+        sendBodyMarcDuino(":OP09\r");
         break;
                 
       case 73:
-        Serial3.print(":CL09\r");
+        sendBodyMarcDuino(":CL09\r");
         break;
                 
       case 74:
-        Serial3.print(":OP10\r");
+        sendBodyMarcDuino(":OP10\r");
         break;
 
       case 75:
-        Serial3.print(":CL10\r");
+        sendBodyMarcDuino(":CL10\r");
         break;
 
       case 76:
-        Serial3.print("*MO99\r");
+        sendBodyMarcDuino("*MO99\r");
         break;
 
       case 77:
-        Serial3.print("*MO00\r");
+        sendBodyMarcDuino("*MO00\r");
         break;
 
       case 78:
-        Serial3.print("*MF10\r");
+        sendBodyMarcDuino("*MF10\r");
         break;
         //Eebel code start
       case 79:
         //Scream and Wiggle Dome and Body
         Serial1.print(":SE16\r");
-        Serial3.print(":SE32\r");
+        sendBodyMarcDuino(":SE32\r");
         break;
       case 80:
         //WaveBye
@@ -888,23 +950,23 @@ void marcDuinoButtonPush(int type, int MD_func, int MP3_num, int LD_type, String
         break;
       case 81:
         //Utility Arm Open and Close
-        Serial3.print(":SE30\r");
+        sendBodyMarcDuino(":SE30\r");
         break;
       case 82:
         //Test all body panels/tools
-        Serial3.print(":SE31\r");
+        sendBodyMarcDuino(":SE31\r");
         break;
       case 83:
         //Use Gripper Arm
-        Serial3.print(":SE33\r");
+        sendBodyMarcDuino(":SE33\r");
         break;
       case 84:
         //Use Interface Tool
-        Serial3.print(":SE34\r");
+        sendBodyMarcDuino(":SE34\r");
         break;
       case 85:
         //Use Ping Pong Big Body Doors 
-        Serial3.print(":SE35\r");
+        sendBodyMarcDuino(":SE35\r");
         break;    
       case 86:
         //Star Wars Disco
@@ -4075,7 +4137,16 @@ boolean criticalFaultDetectDome()
 boolean readUSB()
 {
   
-     Usb.Task();
+     #ifdef SHADOW_DEBUG
+       unsigned long usbTaskStart = micros();
+       Usb.Task();
+       unsigned long usbTaskTime = micros() - usbTaskStart;
+       usbTaskMicros += usbTaskTime;
+       if (usbTaskTime > usbTaskMaxMicros) usbTaskMaxMicros = usbTaskTime;
+       usbTaskCalls++;
+     #else
+       Usb.Task();
+     #endif
      
     //The more devices we have connected to the USB or BlueTooth, the more often Usb.Task need to be called to eliminate latency.
     if (PS3NavFoot->PS3NavigationConnected) 
@@ -4113,6 +4184,19 @@ boolean readUSB()
     return true;
 }
 
+// =======================================================================================
+//          New Controller Input - true when either controller sent a report since the last call
+// =======================================================================================
+
+boolean newControllerInput()
+{
+    boolean newInput = PS3NavFoot->newReportSince(lastFootReport) || PS3NavDome->newReportSince(lastDomeReport);
+    
+    lastFootReport = PS3NavFoot->getReportSequence();
+    lastDomeReport = PS3NavDome->getReportSequence();
+    return newInput;
+}
+
 // =======================================================================================
 //          Print Output Function
 // =======================================================================================
@@ -4125,3 +4209,185 @@ void printOutput()
         output = ""; // Reset output string
     }
 }
+
+// =======================================================================================
+//          Bus Statistics - bytes sent to the Sabertooth/SyRen on Serial2, time in Usb.Task()
+// =======================================================================================
+
+void reportBusStatistics()
+{
+    currentMillis = millis();
+    if ((currentMillis - previousMotorBusReportMillis) < 10000) return;
+    
+    unsigned long sent = motorSerial.bytesSent - lastMotorBusReportBytes;
+    if (sent > 0)
+    {
+        output += "Motor bus: ";
+        output += sent;
+        output += " bytes in ";
+        output += (currentMillis - previousMotorBusReportMillis);
+        output += "ms\r\n";
+    }
+    
+    if (usbTaskCalls > 0)
+    {
+        output += "Usb.Task: ";
+        output += usbTaskMicros / usbTaskCalls;
+        output += "us avg, ";
+        output += usbTaskMaxMicros;
+        output += "us max, ";
+        output += usbTaskCalls;
+        output += " calls\r\n";
+    }
+    
+    usbTaskMicros = 0;
+    usbTaskMaxMicros = 0;
+    usbTaskCalls = 0;
+    lastMotorBusReportBytes = motorSerial.bytesSent;
+    previousMotorBusReportMillis = currentMillis;
+}
+
+// =======================================================================================
+//          Motor Controller Baud Rate - move Serial2 to a faster packet serial rate
+// =======================================================================================
+
+byte packetSerialBaudCode(long baudRate)
+{
+    switch (baudRate)
+    {
+        case 2400:   return 1;
+        case 9600:   return 2;
+        case 19200:  return 3;
+        case 38400:  return 4;
+        case 115200: return 5;
+    }
+    return 0;
+}
+
+// Error (in 0.1%) between a requested rate and what the Mega UART really generates.
+// Same UBRR calculation HardwareSerial::begin() uses in double speed mode.
+long uartBaudErrorPermille(long baudRate)
+{
+    unsigned long ubrr = (F_CPU / 4 / baudRate - 1) / 2;
+    long actual = F_CPU / (8 * (ubrr + 1));
+    return abs(actual - baudRate) * 1000 / baudRate;
+}
+
+// Called from motorBusStartup() with Serial2 running at motorControllerBaudRate.
+// Returns the rate Serial2 is left running at.  If that changed, the drivers restart
+// and need 500ms and a new autobaud before they take commands again.
+long setupMotorBaudRate()
+{
+    long rate = motorControllerFastBaudRate;
+    
+    if (rate == motorControllerBaudRate) return motorControllerBaudRate;
+    
+    if (packetSerialBaudCode(rate) == 0 || uartBaudErrorPermille(rate) > 25)
+    {
+        #ifdef SHADOW_DEBUG
+          output += "Motor baud rate ";
+          output += rate;
+          output += " not usable, staying at ";
+          output += motorControllerBaudRate;
+          output += "\r\n";
+        #endif
+        return motorControllerBaudRate;
+    }
+    
+    // The drivers keep their baud rate in EEPROM and can't be asked for it over a TX only link,
+    // so send the change at every rate they could be listening on.  Whatever rate they booted
+    // with, they end up on the new one.  Sabertooth::setBaudRate() waits 500ms per call, so the
+    // raw command is used here and motorBusStartup() waits once for both drivers to restart.
+    static const long candidateRates[] = { 9600, 2400, 19200, 38400, 115200 };
+    
+    for (byte i = 0; i < sizeof(candidateRates) / sizeof(candidateRates[0]); i++)
+    {
+        if (candidateRates[i] == rate) continue;
+        
+        Serial2.begin(candidateRates[i]);
+        ST->command(15, packetSerialBaudCode(rate));
+        #ifndef SYREN_SIMPLIFIED_SERIAL
+          SyR->command(15, packetSerialBaudCode(rate));
+        #endif
+        Serial2.flush();
+    }
+    
+    Serial2.begin(rate);
+    
+    // Less wire time per packet, so the drive and dome commands can go out more often
+    serialLatency = constrain((long)serialLatency * motorControllerBaudRate / rate, 10, serialLatency);
+    
+    #ifdef SHADOW_DEBUG
+      output += "Motor baud rate: ";
+      output += rate;
+      output += " Latency: ";
+      output += serialLatency;
+      output += "\r\n";
+    #endif
+    
+    return rate;
+}
+
+// =======================================================================================
+//          Motor Controller Startup - runs from loop() so it overlaps USB/Bluetooth setup
+// =======================================================================================
+
+void configureMotorControllers()
+{
+    ST->setTimeout(10);      //DMB:  How low can we go for safety reasons?  multiples of 100ms
+    ST->setDeadband(driveDeadBandRange);
+    ST->stop(); 
+    SyR->setTimeout(20);      //DMB:  How low can we go for safety reasons?  multiples of 100ms
+    SyR->stop(); 
+}
+
+void motorBusStartup()
+{
+    currentMillis = millis();
+    
+    switch (motorBusState)
+    {
+        case MOTOR_BUS_POWERUP:
+            // Same power up wait Sabertooth::autobaud() does, counted from reset
+            if (currentMillis < motorStartupDelay) return;
+            motorSerial.open();
+            Sabertooth::autobaud(motorSerial, true);  // One 0xAA is seen by every driver on the bus
+            motorBusState = MOTOR_BUS_AUTOBAUD;
+            break;
+            
+        case MOTOR_BUS_AUTOBAUD:
+            if ((currentMillis - motorBusStateMillis) < motorAutobaudSettle) return;
+            if (setupMotorBaudRate() != motorControllerBaudRate)
+            {
+                motorBusState = MOTOR_BUS_BAUD_CHANGE;
+                break;
+            }
+            configureMotorControllers();
+            motorBusState = MOTOR_BUS_READY;
+            break;
+            
+        case MOTOR_BUS_BAUD_CHANGE:
+            // Drivers take about 200ms to restart after a baud rate change
+            if ((currentMillis - motorBusStateMillis) < 500) return;
+            Sabertooth::autobaud(motorSerial, true);
+            motorBusState = MOTOR_BUS_NEW_BAUD;
+            break;
+            
+        case MOTOR_BUS_NEW_BAUD:
+            if ((currentMillis - motorBusStateMillis) < motorAutobaudSettle) return;
+            configureMotorControllers();
+            motorBusState = MOTOR_BUS_READY;
+            break;
+    }
+    
+    motorBusStateMillis = currentMillis;
+    
+    #ifdef SHADOW_DEBUG
+      if (motorBusState == MOTOR_BUS_READY)
+      {
+          output += "Motor controllers ready at ";
+          output += currentMillis;
+          output += "ms\r\n";
+      }
+    #endif
+}